@@ -406,6 +406,18 @@ if(UNIX)
     endif(${CMAKE_HOST_SYSTEM_NAME} STREQUAL "FreeBSD")
 
   endif(FLTK_USE_WAYLAND)
+
+  if(NOT APPLE)
+    option(FLTK_BACKEND_HEADLESS "support the headless backend (requires Cairo)" OFF)
+  endif(NOT APPLE)
+
+  # The headless backend draws with Cairo, so X11 windows must use Cairo too.
+  # FLTK_USE_HEADLESS is set below when Cairo and Pango are available.
+
+  if(FLTK_BACKEND_HEADLESS)
+    unset(FLTK_GRAPHICS_CAIRO CACHE)
+    set(FLTK_GRAPHICS_CAIRO TRUE CACHE BOOL "all drawing to X11 windows uses Cairo")
+  endif(FLTK_BACKEND_HEADLESS)
 endif(UNIX)
 
 if(WIN32)
@@ -994,6 +1006,15 @@ if((X11_Xft_FOUND OR NOT USE_PANGOXFT) AND FLTK_USE_PANGO)
 
 endif((X11_Xft_FOUND OR NOT USE_PANGOXFT) AND FLTK_USE_PANGO)
 
+if(FLTK_BACKEND_HEADLESS)
+  if(FLTK_USE_CAIRO)
+    set(FLTK_USE_HEADLESS 1)
+  else()
+    message(NOTICE "The headless backend was requested but can't be built: it requires")
+    message(NOTICE "  the development files of Cairo and Pango (cairo, pangocairo).")
+  endif(FLTK_USE_CAIRO)
+endif(FLTK_BACKEND_HEADLESS)
+
 if(FLTK_USE_WAYLAND)
 
   # Note: Disable FLTK_USE_LIBDECOR_GTK to get cairo titlebars rather than GTK
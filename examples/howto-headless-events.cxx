@@ -0,0 +1,85 @@
+//
+// Demonstrate how to drive an FLTK program without a display server
+//
+//     Run this program with FLTK_BACKEND=headless. It types a text into an
+//     input field and clicks a button with the event functions of the headless
+//     backend, then reads the window contents back with fl_capture_window().
+//     The exit status is 0 if all events were handled as expected, which
+//     makes this a template for automated tests of FLTK programs.
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl.H>
+#include <FL/headless.H>        // fl_headless_...() functions
+#include <FL/Fl_Window.H>
+#include <FL/Fl_Input.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>
+#include <string.h>
+
+static int clicks = 0;
+
+static void button_cb(Fl_Widget *, void *) {
+  clicks++;
+}
+
+int main(int argc, char **argv) {
+  Fl_Window win(300, 100, "Headless events");
+  Fl_Input input(80, 10, 200, 30, "Name:");
+  Fl_Button button(80, 55, 100, 30, "OK");
+  button.color(FL_RED);
+  button.callback(button_cb);
+  win.end();
+  win.show(argc, argv);
+
+  if (!fl_headless_backend()) {
+    printf("Please run this program with FLTK_BACKEND=headless\n");
+    return 1;
+  }
+  Fl::flush();                  // draw the window into its memory buffer
+
+  // click into the input field, then type "Hi" with the Shift key for 'H'
+  fl_headless_mouse_event(&win, FL_PUSH, 100, 25);
+  fl_headless_mouse_event(&win, FL_RELEASE, 100, 25);
+  fl_headless_key_event(&win, FL_KEYDOWN, FL_Shift_L);
+  fl_headless_key_event(&win, FL_KEYDOWN, 'h');
+  fl_headless_key_event(&win, FL_KEYUP, 'h');
+  fl_headless_key_event(&win, FL_KEYUP, FL_Shift_L);
+  fl_headless_key_event(&win, FL_KEYDOWN, 'i');
+  fl_headless_key_event(&win, FL_KEYUP, 'i');
+
+  // click the button
+  fl_headless_mouse_event(&win, FL_PUSH, 130, 70);
+  fl_headless_mouse_event(&win, FL_RELEASE, 130, 70);
+  Fl::flush();
+
+  // the button is red in the captured window
+  int red = 0;
+  Fl_RGB_Image *img = fl_capture_window(&win, 0, 0, win.w(), win.h());
+  if (img && img->d() >= 3) {
+    // the image has more pixels than the window if the screen is scaled
+    int x = 90 * img->data_w() / win.w(), y = 70 * img->data_h() / win.h();
+    const uchar *p = (const uchar *)img->array + (y * img->data_w() + x) * img->d();
+    uchar r, g, b;
+    Fl::get_color(FL_RED, r, g, b);
+    red = (p[0] == r && p[1] == g && p[2] == b);
+  }
+  delete img;
+
+  printf("input: \"%s\", button clicks: %d, button drawn: %s\n",
+         input.value(), clicks, red ? "yes" : "no");
+  return (strcmp(input.value(), "Hi") == 0 && clicks == 1 && red) ? 0 : 1;
+}
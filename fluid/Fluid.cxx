@@ -54,6 +54,12 @@
 #include <locale.h>     // setlocale()..
 #include "../src/flstring.h"
 
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 
 fld::Application Fluid;
 
@@ -149,77 +155,42 @@ int Application::run(int argc,char **argv) {
 
   make_main_window();
 
+  // handle all project files given on the command line and exit
+  if (batch_mode)
+    exit(run_batch());
+
   if (c) {
-    if (batch_mode) {
-      proj.set_filename(c);
-    } else {
-      // In GUI mode, filenames must always be absolute.
-      proj.set_filename(fl_filename_absolute_str(c));
-    }
+    // In GUI mode, filenames must always be absolute.
+    proj.set_filename(fl_filename_absolute_str(c));
   }
-  if (!batch_mode) {
 #ifdef __APPLE__
-    fl_open_callback(apple_open_cb);
+  fl_open_callback(apple_open_cb);
 #endif // __APPLE__
-    Fl::visual((Fl_Mode)(FL_DOUBLE|FL_INDEX));
-    Fl_File_Icon::load_system_icons();
-    main_window->callback(exit_cb);
-    make_fluid_icon(main_window); // assign icon to main window
-    position_window(main_window,"main_window_pos", 1, 10, 30, WINWIDTH, WINHEIGHT );
-    if (g_shell_config) {
-      g_shell_config->read(preferences, fld::Tool_Store::USER);
-      g_shell_config->update_settings_dialog();
-      g_shell_config->rebuild_shell_menu();
-    }
-    Fluid.layout_list.read(preferences, fld::Tool_Store::USER);
-    main_window->show(argc,argv);
-    toggle_widget_bin();
-    if (!c && openlast_button->value() && history.abspath[0][0] && args.autodoc_path.empty()) {
-      // Open previous file when no file specified...
-      open_project_file(history.abspath[0]);
-    }
-    toggle_codeview_cb(nullptr,nullptr);
+  Fl::visual((Fl_Mode)(FL_DOUBLE|FL_INDEX));
+  Fl_File_Icon::load_system_icons();
+  main_window->callback(exit_cb);
+  make_fluid_icon(main_window); // assign icon to main window
+  position_window(main_window,"main_window_pos", 1, 10, 30, WINWIDTH, WINHEIGHT );
+  if (g_shell_config) {
+    g_shell_config->read(preferences, fld::Tool_Store::USER);
+    g_shell_config->update_settings_dialog();
+    g_shell_config->rebuild_shell_menu();
+  }
+  Fluid.layout_list.read(preferences, fld::Tool_Store::USER);
+  main_window->show(argc,argv);
+  toggle_widget_bin();
+  if (!c && openlast_button->value() && history.abspath[0][0] && args.autodoc_path.empty()) {
+    // Open previous file when no file specified...
+    open_project_file(history.abspath[0]);
   }
+  toggle_codeview_cb(nullptr,nullptr);
+
   proj.undo.suspend();
   if (c && !fld::io::read_file(proj, c,0)) {
-    if (batch_mode) {
-      fprintf(stderr,"%s : %s\n", c, strerror(errno));
-      exit(1);
-    }
     fl_message("Can't read %s: %s", c, strerror(errno));
   }
   proj.undo.resume();
 
-  // command line args override code and header filenames from the project file
-  // in batch mode only
-  if (batch_mode) {
-    if (!args.code_filename.empty()) {
-      proj.code_file_set = 1;
-      proj.code_file_name = args.code_filename;
-    }
-    if (!args.header_filename.empty()) {
-      proj.header_file_set = 1;
-      proj.header_file_name = args.header_filename;
-    }
-  }
-
-  if (args.update_file) {            // fluid -u
-    fld::io::write_file(proj, c, 0);
-    if (!args.compile_file)
-      exit(0);
-  }
-
-  if (args.compile_file) {           // fluid -c[s]
-    if (args.compile_strings)
-      proj.write_strings();
-    write_code_files();
-    exit(0);
-  }
-
-  // don't lock up if inconsistent command line arguments were given
-  if (batch_mode)
-    exit(0);
-
   proj.set_modflag(0);
   proj.undo.clear();
 
@@ -244,6 +215,112 @@ int Application::run(int argc,char **argv) {
 }
 
 
+/**
+ Read one project file and write all files requested on the command line.
+
+ The current project is reset before the file is read, so this can be called
+ repeatedly to handle many project files within the same process.
+
+ \param[in] filename the .fl project file, relative to the working directory
+ \return 0 on success, 1 if the project could not be read or a file could not
+    be written
+ */
+int Application::batch_process_file(const std::string &filename) {
+  proj.reset();
+  proj.set_filename(filename);
+
+  proj.undo.suspend();
+  bool read_ok = fld::io::read_file(proj, filename.c_str(), 0);
+  proj.undo.resume();
+  if (!read_ok) {
+    fprintf(stderr,"%s : %s\n", filename.c_str(), strerror(errno));
+    return 1;
+  }
+
+  // command line args override code and header filenames from the project file
+  if (!args.code_filename.empty()) {
+    proj.code_file_set = 1;
+    proj.code_file_name = args.code_filename;
+  }
+  if (!args.header_filename.empty()) {
+    proj.header_file_set = 1;
+    proj.header_file_name = args.header_filename;
+  }
+
+  if (args.update_file) {            // fluid -u
+    fld::io::write_file(proj, filename.c_str(), 0);
+  }
+
+  if (args.compile_file) {           // fluid -c[s]
+    if (args.compile_strings)
+      proj.write_strings();
+    if (write_code_files() != 0)
+      return 1;
+  }
+
+  return 0;
+}
+
+
+/**
+ Handle all project files that were given on the command line in batch mode.
+
+ Project files are handled one after the other, so the cost of launching
+ FLUID is paid only once. If more than one job was requested with `--jobs`,
+ the list of files is distributed over that many worker processes. Every
+ worker has its own copy of the application and hence its own Project and
+ Code_Writer. Unchanged source and header files are never rewritten, so their
+ time stamps are preserved.
+
+ \return 0 if all files were handled successfully, 1 if any file failed
+ */
+int Application::run_batch() {
+  const std::vector<std::string> &files = args.filenames;
+  int n_files = (int)files.size();
+  int n_jobs = (args.jobs < n_files) ? args.jobs : n_files;
+  int err = 0;
+
+#ifndef _WIN32
+  if (n_jobs > 1) {
+    std::vector<pid_t> workers;
+    std::vector<int> orphaned_slices;
+    fflush(stdout);
+    fflush(stderr);
+    for (int j = 0; j < n_jobs; j++) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        // worker process: handle every n-th file, starting at j
+        int worker_err = 0;
+        for (int k = j; k < n_files; k += n_jobs)
+          worker_err |= batch_process_file(files[k]);
+        fflush(stdout);
+        fflush(stderr);
+        _exit(worker_err);
+      } else if (pid > 0) {
+        workers.push_back(pid);
+      } else {
+        // could not fork, handle this slice in this process later
+        orphaned_slices.push_back(j);
+      }
+    }
+    for (int j : orphaned_slices)
+      for (int k = j; k < n_files; k += n_jobs)
+        err |= batch_process_file(files[k]);
+    for (pid_t pid : workers) {
+      int status = 0;
+      if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        err = 1;
+    }
+    return err;
+  }
+#endif
+
+  for (const std::string &filename : files)
+    err |= batch_process_file(filename);
+  return err;
+}
+
+
 /**
  Exit Fluid; we hope you had a nice experience.
  If the design was modified, a dialog will ask for confirmation.
@@ -835,7 +912,7 @@ void Application::print_snapshots() {
  presented to the user.
 
  In batch_mode, the function will either be silent, or, if opening or writing
- the files fails, write an error message to \c stderr and exit with exit code 1.
+ the files fails, write an error message to \c stderr and return 1.
 
  In interactive mode, it will pop up an error message, or, if the user
  hasn't disabled that, pop up a confirmation message.
@@ -871,7 +948,7 @@ int Application::write_code_files(bool dont_show_completion_dialog)
               code_filename_rel.c_str(),
               header_filename_rel.c_str(),
               strerror(errno));
-      exit(1);
+      return 1;
     }
   } else {
     if (!x) {
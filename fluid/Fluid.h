@@ -169,6 +169,10 @@ public: // Methods
   void print_snapshots();
   // Generate the C++ source and header filenames and write those files.
   int write_code_files(bool dont_show_completion_dialog=false);
+  // Read one project file and write the files requested on the command line.
+  int batch_process_file(const std::string &filename);
+  // Handle all project files given on the command line in batch mode.
+  int run_batch();
 
   // User chose to cut the currently selected widgets.
   void cut_selected();
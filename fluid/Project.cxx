@@ -109,7 +109,7 @@ std::string Project::codefile_name() const {
     return fl_filename_setext_str(fl_filename_name(proj_filename), ".cxx");
   } else if (name[0] == '.') {
     if (!proj_filename) return std::string{};
-    return fl_filename_setext_str(fl_filename_name(proj_filename), code_file_name);
+    return fl_filename_setext_str(fl_filename_name(proj_filename), name);
   } else {
     return name;
   }
@@ -138,7 +138,7 @@ std::string Project::headerfile_name() const {
     return fl_filename_setext_str(fl_filename_name_str(proj_filename), ".h");
   } else if (name[0] == '.') {
     if (!proj_filename) return std::string{};
-    return fl_filename_setext_str(fl_filename_name_str(proj_filename), header_file_name);
+    return fl_filename_setext_str(fl_filename_name_str(proj_filename), name);
   } else {
     return name;
   }
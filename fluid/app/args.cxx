@@ -21,6 +21,13 @@
 #include <FL/Fl.H>
 #include <FL/filename.H>
 #include <FL/fl_ask.H>
+#include <FL/fl_utf8.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 using namespace fld;
 using namespace fld::app;
@@ -36,17 +43,38 @@ using namespace fld::app;
 int Args::load(int argc,char **argv) {
   int i = 1;
   Fl::args_to_utf8(argc, argv); // for MSYS2/MinGW
-  if (   (Fl::args(argc,argv,i,arg_cb) == 0)     // unsupported argument found
-      || (Fluid.batch_mode && (i != argc-1))        // .fl filename missing
+  int args_ok = Fl::args(argc,argv,i,arg_cb);
+  // In batch mode, collect all remaining filenames and expand response files
+  bool files_ok = true;
+  if (args_ok && Fluid.batch_mode) {
+    for (int j = i; j < argc; j++) {
+      if (argv[j][0] == '-' || !add_filename(argv[j])) {
+        files_ok = false;
+        break;
+      }
+    }
+    // More than one project can't share an explicit output filename, but
+    // they can share an extension, optionally in a directory ("out/.cxx")
+    if (filenames.size() > 1) {
+      const char *code_name = fl_filename_name(code_filename.c_str());
+      const char *header_name = fl_filename_name(header_filename.c_str());
+      if ((code_name[0] && code_name[0] != '.') || (header_name[0] && header_name[0] != '.'))
+        files_ok = false;
+    }
+  }
+  if (   (args_ok == 0)                             // unsupported argument found
+      || (Fluid.batch_mode && filenames.empty())    // .fl filename missing
+      || !files_ok                                  // unreadable response file
       || (!Fluid.batch_mode && (i < argc-1))        // more than one filename found
       || (argv[i] && (argv[i][0] == '-'))) {  // unknown option
     static const char *msg =
-    "usage: %s <switches> name.fl\n"
+    "usage: %s <switches> name.fl [name2.fl ...] [@response_file]\n"
     " -u : update .fl file and exit (may be combined with '-c' or '-cs')\n"
     " -c : write .cxx and .h and exit\n"
     " -cs : write .cxx and .h and strings and exit\n"
     " -o <name> : .cxx output filename, or extension if <name> starts with '.'\n"
     " -h <name> : .h output filename, or extension if <name> starts with '.'\n"
+    " --jobs <n>, -j <n> : number of worker processes for multiple .fl files\n"
     " --help : brief usage information\n"
     " --version, -v : print fluid version number\n"
     " -d : enable internal debugging\n";
@@ -117,6 +145,12 @@ int Args::arg(int argc, char** argv, int& i) {
     i += 2; return 2;
   }
 #endif
+  if (   ((strcmp(argv[i], "--jobs") == 0) || (strcmp(argv[i], "-j") == 0))
+      && (i+1 < argc) ) {
+    jobs = atoi(argv[i+1]);
+    if (jobs < 1) jobs = 1;
+    i += 2; return 2;
+  }
   if (strcmp(argv[i], "--help")==0) {
     return 0;
   }
@@ -134,3 +168,38 @@ int Args::arg(int argc, char** argv, int& i) {
   return 0;
 }
 
+
+
+/**
+ Add a project filename to the list of files that will be handled in batch mode.
+
+ If the name starts with an '@', the rest of the name is the path to a
+ response file. Every non-empty line in that file is the name of another
+ project file. Lines starting with '#' are ignored.
+
+ \param[in] name project filename or \@response file
+ \return false if the response file could not be read
+ */
+bool Args::add_filename(const char *name) {
+  if (name[0] != '@') {
+    filenames.push_back(name);
+    return true;
+  }
+  FILE *f = fl_fopen(name+1, "rb");
+  if (!f) {
+    fprintf(stderr, "%s : %s\n", name+1, strerror(errno));
+    return false;
+  }
+  char line[FL_PATH_MAX+1];
+  while (fgets(line, sizeof(line), f)) {
+    // strip trailing whitespace and line endings
+    size_t n = strlen(line);
+    while (n > 0 && isspace((unsigned char)line[n-1])) line[--n] = 0;
+    const char *start = line;
+    while (*start && isspace((unsigned char)*start)) start++;
+    if (!*start || *start == '#') continue;
+    filenames.push_back(start);
+  }
+  fclose(f);
+  return true;
+}
@@ -18,6 +18,7 @@
 #define FLUID_APP_ARGS_H
 
 #include <string>
+#include <vector>
 
 namespace fld {
 namespace app {
@@ -27,6 +28,8 @@ class Args {
   static int arg_cb(int argc, char** argv, int& i);
   // Handle args individually.
   int arg(int argc, char** argv, int& i);
+  // Add a project filename or the contents of a response file to the list.
+  bool add_filename(const char *name);
 public:
   /// Set, if Fluid was started with the command line argument -u
   int update_file { 0 };            // fluid -u
@@ -42,6 +45,10 @@ public:
   std::string autodoc_path { };         // fluid --autodoc path
   /// Set, if Fluid was started with the command line argument -v
   int show_version { 0 };           // fluid -v
+  /// Number of worker processes used when compiling more than one project file
+  int jobs { 1 };                   // fluid --jobs N
+  /// All project files given on the command line, with \@response files expanded
+  std::vector<std::string> filenames { };
   /// Constructor.
   Args() = default;
   // Load args from command line into variables.
@@ -691,8 +691,10 @@ int Code_Writer::write_code(const char *s, const char *t, bool to_codeview) {
   if (t && proj_.include_H_from_C) {
     if (to_codeview) {
       write_c("#include \"CodeView.h\"\n");
-    } else if (proj_.header_file_name[0] == '.' && strchr(proj_.header_file_name.c_str(), '/') == nullptr) {
-      write_c("#include \"%s\"\n", fl_filename_name(t));
+    } else if (fl_filename_name(proj_.header_file_name.c_str())[0] == '.') {
+      // an extension, optionally in a directory, see Project::headerfile_name()
+      write_c("#include \"%s%s\"\n", fl_filename_path_str(proj_.header_file_name).c_str(),
+              fl_filename_name(t));
     } else {
       write_c("#include \"%s\"\n", proj_.header_file_name.c_str());
     }
@@ -32,6 +32,9 @@
 #include <stdlib.h>
 #include "flstring.h"
 
+#include <unordered_map>
+#include <vector>
+
 #if defined(DEBUG) || defined(DEBUG_WATCH)
 #  include <stdio.h>
 #endif // DEBUG || DEBUG_WATCH
@@ -76,6 +79,10 @@ unsigned char   Fl::Private::options_read_ = 0;
 
 int             Fl::Private::selection_to_clipboard_ = 0;
 
+int             Fl::Private::motion_compression_ = 0;
+int             Fl::Private::event_history_n_ = 0;
+int             Fl::Private::event_history_xy_[2 * Fl::Private::event_history_max_];
+
 Fl_Window       *fl_xfocus = NULL; // which window X thinks has focus
 Fl_Window       *fl_xmousewin;     // which window X thinks has FL_ENTER
 Fl_Window       *Fl::grab_;        // most recent Fl::grab()
@@ -126,6 +133,87 @@ int Fl::selection_to_clipboard() {
   return Private::selection_to_clipboard_;
 }
 
+/**
+  Combines queued mouse motion events if enabled.
+
+  High rate mice and graphics tablets can report hundreds of positions per
+  second. By default, each of them is sent to the widgets as an FL_MOVE or
+  FL_DRAG event. If motion compression is switched on (\p mode = 1) and a
+  widget takes longer to handle an event than the device needs to report
+  the next position, all motion events of the same window and with the
+  same mouse button and modifier key state that are waiting in the event
+  queue are combined into one event with the most recent position. The
+  positions that were skipped are available with Fl::event_history() while
+  the event is handled, for instance to draw all points of a stroke.
+
+  This can be called on all platforms, but only the X11 platform combines
+  events. Other platforms combine mouse motion events by themselves, or
+  don't support this feature, and Fl::event_history() returns 0.
+
+  The default is to send all motion events (disabled).
+
+  \param[in] mode 1 = combine queued motion events, 0 = send all motion events
+
+  \see Fl::event_history()
+  \since 1.5.0
+*/
+void Fl::motion_compression(int mode) {
+  Private::motion_compression_ = mode ? 1 : 0;
+}
+
+/**
+  \brief Returns the current motion compression mode.
+
+  \see void motion_compression(int)
+  \since 1.5.0
+*/
+int Fl::motion_compression() {
+  return Private::motion_compression_;
+}
+
+/**
+  Returns the number of mouse positions skipped by motion compression.
+
+  While an FL_MOVE or FL_DRAG event is handled and Fl::motion_compression()
+  is enabled, this returns the number of motion events that were combined
+  into the current event, not counting the current event. Their positions,
+  relative to the window like Fl::event_x() and Fl::event_y(), are returned
+  by Fl::event_history_x(int) and Fl::event_history_y(int), from the oldest
+  (index 0) to the newest. Only the last 1024 positions are kept.
+
+  \return number of skipped positions, 0 if there are none or the current
+    event is not an FL_MOVE or FL_DRAG event
+
+  \see Fl::motion_compression(int)
+  \since 1.5.0
+*/
+int Fl::event_history() {
+  if (e_number != FL_MOVE && e_number != FL_DRAG) return 0;
+  return Private::event_history_n_;
+}
+
+/**
+  Returns the horizontal position of a mouse position skipped by motion compression.
+  \param[in] i index from 0 (oldest) to Fl::event_history() - 1 (newest)
+  \see Fl::event_history()
+  \since 1.5.0
+*/
+int Fl::event_history_x(int i) {
+  if (i < 0 || i >= event_history()) return e_x;
+  return Private::event_history_xy_[2 * i];
+}
+
+/**
+  Returns the vertical position of a mouse position skipped by motion compression.
+  \param[in] i index from 0 (oldest) to Fl::event_history() - 1 (newest)
+  \see Fl::event_history()
+  \since 1.5.0
+*/
+int Fl::event_history_y(int i) {
+  if (i < 0 || i >= event_history()) return e_y;
+  return Private::event_history_xy_[2 * i + 1];
+}
+
 //
 // Drivers
 //
@@ -1631,6 +1719,13 @@ int Fl::handle_(int e, Fl_Window* window)
   case FL_SHORTCUT:
     if (grab()) {wi = grab(); break;} // send it to grab window
 
+    // Try the widgets registered with Fl_Window::add_shortcut():
+    {
+      Fl_Window *sw = modal() ? modal() : window;
+      if (sw) sw = sw->top_window();
+      if (sw && sw->send_shortcut()) return 1;
+    }
+
     // Try it as shortcut, sending to mouse widget and all parents:
     wi = find_active(belowmouse()); // STR #3216
     if (!wi) {
@@ -1955,9 +2050,32 @@ void Fl::do_widget_deletion() {
 }
 
 
-static Fl_Widget ***widget_watch = 0;
-static int num_widget_watch = 0;
-static int max_widget_watch = 0;
+// The widget watch list. Pointers added with Fl::watch_widget_pointer() may
+// be changed by their owners at any time, so they are searched for the
+// deleted widget. Pointers added with Fl::Private::track_widget_pointer_()
+// are only changed by clearing them, so they are found by the widget they
+// pointed to when they were added. Adding, releasing and clearing them
+// doesn't depend on the number of tracked pointers. A widget is rarely
+// tracked by more than a few pointers.
+typedef std::vector<Fl_Widget**> Fl_Widget_Watch_List;
+static Fl_Widget_Watch_List *watched_pointers = 0;
+static std::unordered_map<Fl_Widget**, const Fl_Widget*> *tracked_pointers = 0;
+static std::unordered_map<const Fl_Widget*, Fl_Widget_Watch_List> *tracked_widgets = 0;
+
+// removes wp from the pointers that track w
+static void untrack_widget(const Fl_Widget *w, Fl_Widget **wp) {
+  std::unordered_map<const Fl_Widget*, Fl_Widget_Watch_List>::iterator it = tracked_widgets->find(w);
+  if (it == tracked_widgets->end()) return;
+  Fl_Widget_Watch_List &list = it->second;
+  for (size_t i = 0; i < list.size(); i++) {
+    if (list[i] == wp) {
+      list[i] = list.back();
+      list.pop_back();
+      break;
+    }
+  }
+  if (list.empty()) tracked_widgets->erase(it);
+}
 
 
 /**
@@ -2008,18 +2126,14 @@ static int max_widget_watch = 0;
 void Fl::watch_widget_pointer(Fl_Widget *&w)
 {
   Fl_Widget **wp = &w;
-  int i;
-  for (i=0; i<num_widget_watch; ++i) {
-    if (widget_watch[i]==wp) return;
-  }
-  if (num_widget_watch==max_widget_watch) {
-    max_widget_watch += 8;
-    widget_watch = (Fl_Widget***)realloc(widget_watch, sizeof(Fl_Widget**)*max_widget_watch);
+  if (!watched_pointers) watched_pointers = new Fl_Widget_Watch_List;
+  for (size_t i = 0; i < watched_pointers->size(); i++) {
+    if ((*watched_pointers)[i] == wp) return;
   }
-  widget_watch[num_widget_watch++] = wp;
+  watched_pointers->push_back(wp);
 #ifdef DEBUG_WATCH
-  printf ("\nwatch_widget_pointer:   (%d/%d) %8p => %8p\n",
-    num_widget_watch,num_widget_watch,wp,*wp);
+  printf ("\nwatch_widget_pointer:   (%d) %8p => %8p\n",
+    (int)watched_pointers->size(),wp,*wp);
   fflush(stdout);
 #endif // DEBUG_WATCH
 }
@@ -2037,26 +2151,62 @@ void Fl::watch_widget_pointer(Fl_Widget *&w)
 */
 void Fl::release_widget_pointer(Fl_Widget *&w)
 {
+  if (!watched_pointers) return;
   Fl_Widget **wp = &w;
-  int i,j=0;
-  for (i=0; i<num_widget_watch; ++i) {
-    if (widget_watch[i]!=wp) {
-      if (j<i) widget_watch[j] = widget_watch[i]; // fill gap
-      j++;
-    }
+  for (size_t i = 0; i < watched_pointers->size(); i++) {
+    if ((*watched_pointers)[i] == wp) {
 #ifdef DEBUG_WATCH
-    else { // found widget pointer
       printf("release_widget_pointer: (%d/%d) %8p => %8p\n",
-             i+1, num_widget_watch, wp, *wp);
-    }
+             (int)i+1, (int)watched_pointers->size(), wp, *wp);
+      fflush(stdout);
 #endif //DEBUG_WATCH
+      watched_pointers->erase(watched_pointers->begin() + i);
+      return;
+    }
   }
-  num_widget_watch = j;
-#ifdef DEBUG_WATCH
-  printf ("                        num_widget_watch = %d\n\n",num_widget_watch);
-  fflush(stdout);
-#endif // DEBUG_WATCH
-  return;
+}
+
+
+/**
+  Adds a widget pointer that is only changed by clearing it to the watch list.
+
+  This works like Fl::watch_widget_pointer(), but the pointer is found by the
+  widget it points to when it is added, so that it takes constant time to add,
+  release and clear it. The owner of the pointer must not change it while it
+  is tracked, except by setting it to NULL. Fl_Widget_Tracker uses this.
+
+  \see Fl::Private::release_tracked_pointer_()
+*/
+void Fl::Private::track_widget_pointer_(Fl_Widget *&w)
+{
+  Fl_Widget **wp = &w;
+  if (!tracked_pointers) {
+    tracked_pointers = new std::unordered_map<Fl_Widget**, const Fl_Widget*>;
+    tracked_widgets = new std::unordered_map<const Fl_Widget*, Fl_Widget_Watch_List>;
+  }
+  std::pair<std::unordered_map<Fl_Widget**, const Fl_Widget*>::iterator, bool> added =
+    tracked_pointers->insert(std::make_pair(wp, (const Fl_Widget*)w));
+  if (!added.second) { // already tracked
+    if (added.first->second == w) return;
+    // the pointer was cleared since it was added
+    if (added.first->second) untrack_widget(added.first->second, wp);
+    added.first->second = w;
+  }
+  if (w) (*tracked_widgets)[w].push_back(wp);
+}
+
+
+/**
+  Releases a widget pointer added with Fl::Private::track_widget_pointer_().
+*/
+void Fl::Private::release_tracked_pointer_(Fl_Widget *&w)
+{
+  if (!tracked_pointers) return;
+  Fl_Widget **wp = &w;
+  std::unordered_map<Fl_Widget**, const Fl_Widget*>::iterator it = tracked_pointers->find(wp);
+  if (it == tracked_pointers->end()) return;
+  if (it->second) untrack_widget(it->second, wp);
+  tracked_pointers->erase(it);
 }
 
 
@@ -2071,7 +2221,8 @@ void Fl::release_widget_pointer(Fl_Widget *&w)
   This method searches the widget watch list for pointers to the widget and
   clears each pointer that points to it. Widget pointers can be added to the
   widget watch list by calling Fl::watch_widget_pointer() or by using the
-  helper class Fl_Widget_Tracker (recommended).
+  helper class Fl_Widget_Tracker (recommended). Pointers that are tracked by
+  Fl_Widget_Tracker are found without searching the list.
 
   \see Fl::watch_widget_pointer()
   \see class Fl_Widget_Tracker
@@ -2079,12 +2230,20 @@ void Fl::release_widget_pointer(Fl_Widget *&w)
 void Fl::clear_widget_pointer(Fl_Widget const *w)
 {
   if (w==0L) return;
-  int i;
-  for (i=0; i<num_widget_watch; ++i) {
-    if (widget_watch[i] && *widget_watch[i]==w) {
-      *widget_watch[i] = 0L;
+  if (watched_pointers) {
+    for (size_t i = 0; i < watched_pointers->size(); i++) {
+      if (*(*watched_pointers)[i] == w) *(*watched_pointers)[i] = 0L;
     }
   }
+  if (!tracked_widgets) return;
+  std::unordered_map<const Fl_Widget*, Fl_Widget_Watch_List>::iterator it = tracked_widgets->find(w);
+  if (it == tracked_widgets->end()) return;
+  Fl_Widget_Watch_List &list = it->second;
+  for (size_t i = 0; i < list.size(); i++) {
+    if (*list[i] == w) *list[i] = 0L;
+    (*tracked_pointers)[list[i]] = 0L; // still tracked until it is released
+  }
+  tracked_widgets->erase(it);
 }
 
 
@@ -2241,7 +2400,7 @@ void Fl::option(Fl_Option opt, bool val)
 Fl_Widget_Tracker::Fl_Widget_Tracker(Fl_Widget *wi)
 {
   wp_ = wi;
-  Fl::watch_widget_pointer(wp_); // add pointer to watch list
+  Fl::Private::track_widget_pointer_(wp_); // add pointer to watch list
 }
 
 /**
@@ -2249,7 +2408,7 @@ Fl_Widget_Tracker::Fl_Widget_Tracker(Fl_Widget *wi)
 */
 Fl_Widget_Tracker::~Fl_Widget_Tracker()
 {
-  Fl::release_widget_pointer(wp_); // remove pointer from watch list
+  Fl::Private::release_tracked_pointer_(wp_); // remove pointer from watch list
 }
 
 int Fl::Private::use_high_res_GL_ = 0;
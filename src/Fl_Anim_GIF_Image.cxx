@@ -27,6 +27,12 @@
 
 #include <FL/Fl_Anim_GIF_Image.H>
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
 /** \class Fl_Anim_GIF_Image
 
  The Fl_Anim_GIF_Image class supports loading, caching, and drawing of animated
@@ -38,6 +44,14 @@
  The user must supply an FLTK widget as "container" in order to see the
  animation by specifying it in the constructor or later using the
  canvas() method.
+
+ Per default all frames are decoded and composed to full images when the file
+ is loaded. With the \ref LAZY_DECODE flag only the color indices of the frames
+ are kept, and a frame is composed when it is shown. Composed frames of all
+ animations loaded with this flag share a memory budget, see
+ frame_cache_size(). This is intended for programs that show many animations
+ at the same time, e.g. a page of thumbnails. The \ref SHARED_TIMER and
+ \ref AUTO_PAUSE flags reduce the cost of such pages further.
 */
 
 /*static*/
@@ -82,7 +96,12 @@ class Fl_Anim_GIF_Image::FrameInfo {
       h(0),
       delay(0),
       dispose(DISPOSE_UNDEF),
-      transparent_color_index(-1) {}
+      transparent_color_index(-1),
+      bits(0),
+      cmap(0),
+      own_cmap(false),
+      clrs(0),
+      trans(-1) {}
     Fl_RGB_Image *rgb;                // full frame image
     Fl_Shared_Image *scalable;        // used for hardware-accelerated scaling
     Fl_Color average_color;           // last average color
@@ -93,6 +112,11 @@ class Fl_Anim_GIF_Image::FrameInfo {
     Dispose dispose;                  // disposal method
     int transparent_color_index;      // needed for dispose()
     RGBA_Color transparent_color;     // needed for dispose()
+    uchar *bits;                      // color indices of the frame (lazy decoding)
+    uchar *cmap;                      // RGB palette of the frame (lazy decoding)
+    bool own_cmap;                    // false if cmap is shared with the previous frame
+    int clrs;                         // number of colors in cmap
+    int trans;                        // transparent color index as passed by the decoder
   };
 
   FrameInfo(Fl_Anim_GIF_Image *anim) :
@@ -111,6 +135,9 @@ class Fl_Anim_GIF_Image::FrameInfo {
     scaling((Fl_RGB_Scaling)0),
     debug_(0),
     optimize_mem(false),
+    lazy(false),
+    data_w(0),
+    data_h(0),
     offscreen(0) {}
   ~FrameInfo();
   void clear();
@@ -122,6 +149,8 @@ class Fl_Anim_GIF_Image::FrameInfo {
   void resize(int W, int H);
   void scale_frame(int frame);
   void set_frame(int frame);
+  Fl_RGB_Image *frame_image(int frame);
+  static void cache_evict(size_t needed);
 private:
   Fl_Anim_GIF_Image *anim;          // a pointer to the Image (only needed for name())
   bool valid;                       // flag if valid data
@@ -140,15 +169,59 @@ private:
   Fl_RGB_Scaling scaling;           // saved scaling method for scale_frame()
   int debug_;                       // Flag for debug outputs
   bool optimize_mem;                // Flag to store frames in original dimensions
+  bool lazy;                        // Flag to compose frames when they are shown
+  int data_w;                       // width of the composed frames (lazy decoding)
+  int data_h;                       // height of the composed frames (lazy decoding)
   uchar *offscreen;                 // internal "offscreen" buffer
 private:
-private:
-  void dispose(int frame_);
+  // composed frames of all animations with lazy decoding, most recently used first
+  typedef std::pair<FrameInfo *, int> CacheKey;
+  typedef std::list<CacheKey> CacheList;
+  typedef std::map<CacheKey, CacheList::iterator> CacheMap;
+  static CacheList cache_lru;
+  static CacheMap cache_index;
+  static size_t cache_limit;
+  static size_t cache_bytes;
+  void cache_release(int frame_);
+  void cache_remove();
+  void compose(int frame_, uchar *dst);
+  bool composed(int frame_) const;
+  void dispose(int frame_, uchar *dst);
+  void draw_bits(int frame_, uchar *dst);
   void on_frame_data(Fl_GIF_Image::GIF_FRAME &gf);
   void on_extension_data(Fl_GIF_Image::GIF_FRAME &gf);
-  void set_to_background(int frame_);
+  void set_to_background(int frame_, uchar *dst);
+};
+
+
+/*static*/
+Fl_Anim_GIF_Image::FrameInfo::CacheList Fl_Anim_GIF_Image::FrameInfo::cache_lru;
+/*static*/
+Fl_Anim_GIF_Image::FrameInfo::CacheMap Fl_Anim_GIF_Image::FrameInfo::cache_index;
+/*static*/
+size_t Fl_Anim_GIF_Image::FrameInfo::cache_limit = 16 * 1024 * 1024; // bytes
+/*static*/
+size_t Fl_Anim_GIF_Image::FrameInfo::cache_bytes = 0;
+
+
+// Animations with the same frame delay and the SHARED_TIMER flag are
+// advanced by one common timeout.
+class Fl_Anim_GIF_Image::Timer {
+public:
+  static void add(Fl_Anim_GIF_Image *anim, double delay);
+  void remove(Fl_Anim_GIF_Image *anim);
+private:
+  Timer(double d) : delay(d) {}
+  static void cb_tick(void *d);
+  static std::map<double, Timer *> timers;
+  double delay;
+  std::vector<Fl_Anim_GIF_Image *> waiting; // animations to advance at the next tick
+  std::vector<Fl_Anim_GIF_Image *> firing;  // animations being advanced now
 };
 
+/*static*/
+std::map<double, Fl_Anim_GIF_Image::Timer *> Fl_Anim_GIF_Image::Timer::timers;
+
 
 #define LOG(x) if (debug()) printf x
 #define DEBUG(x) if (debug() >= 2) printf x
@@ -169,12 +242,55 @@ Fl_Anim_GIF_Image::FrameInfo::~FrameInfo() {
 }
 
 
+void Fl_Anim_GIF_Image::FrameInfo::cache_evict(size_t needed) {
+  while (!cache_lru.empty() && cache_bytes + needed > cache_limit) {
+    CacheKey key = cache_lru.back();
+    key.first->cache_release(key.second);
+  }
+}
+
+
+void Fl_Anim_GIF_Image::FrameInfo::cache_release(int frame) {
+  // remove a composed frame from the cache and free it
+  CacheMap::iterator it = cache_index.find(CacheKey(this, frame));
+  if (it != cache_index.end()) {
+    cache_lru.erase(it->second);
+    cache_index.erase(it);
+  }
+  GifFrame &f = frames[frame];
+  if (f.rgb)
+    cache_bytes -= (size_t)f.rgb->data_w() * f.rgb->data_h() * 4;
+  if (f.scalable)
+    f.scalable->release();
+  delete f.rgb;
+  f.rgb = 0;
+  f.scalable = 0;
+  f.average_color = FL_BLACK;
+  f.average_weight = -1;
+  f.desaturated = false;
+}
+
+
+void Fl_Anim_GIF_Image::FrameInfo::cache_remove() {
+  // release all composed frames of this animation
+  for (int i = 0; i < frames_size; i++) {
+    if (frames[i].rgb)
+      cache_release(i);
+  }
+}
+
+
 void Fl_Anim_GIF_Image::FrameInfo::clear() {
   // release all allocated memory
+  if (lazy)
+    cache_remove();
   while (frames_size-- > 0) {
     if (frames[frames_size].scalable)
       frames[frames_size].scalable->release();
     delete frames[frames_size].rgb;
+    delete[] frames[frames_size].bits;
+    if (frames[frames_size].own_cmap)
+      delete[] frames[frames_size].cmap;
   }
   delete[] offscreen;
   offscreen = 0;
@@ -184,6 +300,29 @@ void Fl_Anim_GIF_Image::FrameInfo::clear() {
 }
 
 
+void Fl_Anim_GIF_Image::FrameInfo::compose(int frame, uchar *dst) {
+  // Compose the canvas as it looks after drawing 'frame' from the stored
+  // color indices, starting at the nearest earlier frame still composed.
+  int start = frame - 1;
+  while (start >= 0 && !composed(start))
+    start--;
+  if (start >= 0)
+    memcpy(dst, frames[start].rgb->array, data_w * data_h * 4);
+  else
+    memset(dst, 0, data_w * data_h * 4);
+  for (int f = start + 1; f <= frame; f++) {
+    dispose(f - 1, dst);
+    draw_bits(f, dst);
+  }
+}
+
+
+bool Fl_Anim_GIF_Image::FrameInfo::composed(int frame) const {
+  // only unmodified frames can be used as the base of following frames
+  return frames[frame].rgb && frames[frame].average_weight < 0 && !frames[frame].desaturated;
+}
+
+
 double Fl_Anim_GIF_Image::FrameInfo::convert_delay(int d) const {
   if (d <= 0)
     d = loop_count != 1 ? 10 : 0;
@@ -192,6 +331,36 @@ double Fl_Anim_GIF_Image::FrameInfo::convert_delay(int d) const {
 
 
 void Fl_Anim_GIF_Image::FrameInfo::copy(const FrameInfo& fi) {
+  if (fi.lazy) {
+    // copy the color indices, frames are composed when they are shown
+    lazy = true;
+    data_w = fi.data_w;
+    data_h = fi.data_h;
+    background_color_index = fi.background_color_index;
+    background_color = fi.background_color;
+    for (int i = 0; i < fi.frames_size; i++) {
+      if (!push_back_frame(fi.frames[i])) {
+        break;
+      }
+      GifFrame &f = frames[i];
+      f.rgb = 0;
+      f.scalable = 0;
+      f.average_color = FL_BLACK;
+      f.average_weight = -1;
+      f.desaturated = false;
+      f.bits = new uchar[f.w * f.h];
+      memcpy(f.bits, fi.frames[i].bits, f.w * f.h);
+      if (!fi.frames[i].own_cmap) {
+        f.cmap = frames[i - 1].cmap;
+      } else {
+        f.cmap = new uchar[f.clrs * 3];
+        memcpy(f.cmap, fi.frames[i].cmap, f.clrs * 3);
+      }
+    }
+    scaling = Fl_Image::RGB_scaling();
+    loop_count = fi.loop_count;
+    return;
+  }
   // copy from source
   for (int i = 0; i < fi.frames_size; i++) {
     if (!push_back_frame(fi.frames[i])) {
@@ -217,11 +386,11 @@ void Fl_Anim_GIF_Image::FrameInfo::copy(const FrameInfo& fi) {
 }
 
 
-void Fl_Anim_GIF_Image::FrameInfo::dispose(int frame) {
+void Fl_Anim_GIF_Image::FrameInfo::dispose(int frame, uchar *dst) {
   if (frame < 0) {
     return;
   }
-  // dispose frame with index 'frame_' to offscreen buffer
+  // dispose frame with index 'frame_' to buffer 'dst'
   switch (frames[frame].dispose) {
     case DISPOSE_PREVIOUS: {
         // dispose to previous restores to first not DISPOSE_TO_PREVIOUS frame
@@ -229,31 +398,38 @@ void Fl_Anim_GIF_Image::FrameInfo::dispose(int frame) {
         while (prev > 0 && frames[prev].dispose == DISPOSE_PREVIOUS)
           prev--;
         if (prev == 0 && frames[prev].dispose == DISPOSE_PREVIOUS) {
-          set_to_background(frame);
+          set_to_background(frame, dst);
           return;
         }
         DEBUG(("  dispose frame %d to previous frame %d\n", frame + 1, prev + 1));
+        if (lazy) {
+          // the previous frame may have been released from the cache
+          if (composed(prev))
+            memcpy(dst, frames[prev].rgb->array, data_w * data_h * 4);
+          else
+            compose(prev, dst);
+          break;
+        }
         // copy the previous image data..
-        uchar *dst = offscreen;
         int px = frames[prev].x;
         int py = frames[prev].y;
         int pw = frames[prev].w;
         int ph = frames[prev].h;
         const char *src = frames[prev].rgb->data()[0];
-        if (px == 0 && py == 0 && pw == canvas_w && ph == canvas_h)
-          memcpy((char *)dst, (char *)src, canvas_w * canvas_h * 4);
+        if (px == 0 && py == 0 && pw == data_w && ph == data_h)
+          memcpy((char *)dst, (char *)src, data_w * data_h * 4);
         else {
-          if ( px + pw > canvas_w ) pw = canvas_w - px;
-          if ( py + ph > canvas_h ) ph = canvas_h - py;
+          if ( px + pw > data_w ) pw = data_w - px;
+          if ( py + ph > data_h ) ph = data_h - py;
           for (int y = 0; y < ph; y++) {
-            memcpy(dst + ( y + py ) * canvas_w * 4 + px, src + y * frames[prev].w * 4, pw * 4);
+            memcpy(dst + ( y + py ) * data_w * 4 + px * 4, src + y * frames[prev].w * 4, pw * 4);
           }
         }
         break;
       }
     case DISPOSE_BACKGROUND:
       DEBUG(("  dispose frame %d to background\n", frame + 1));
-      set_to_background(frame);
+      set_to_background(frame, dst);
       break;
 
     default: {
@@ -264,6 +440,55 @@ void Fl_Anim_GIF_Image::FrameInfo::dispose(int frame) {
 }
 
 
+void Fl_Anim_GIF_Image::FrameInfo::draw_bits(int frame, uchar *dst) {
+  // draw the stored color indices of a frame to buffer 'dst'
+  const GifFrame &f = frames[frame];
+  const uchar *bits = f.bits;
+  const uchar *endp = dst + data_w * data_h * 4;
+  for (int y = f.y; y < f.y + f.h; y++) {
+    for (int x = f.x; x < f.x + f.w; x++) {
+      uchar c = *bits++;
+      if (c == f.trans)
+        continue;
+      uchar *buf = dst + (y * data_w * 4 + (x * 4));
+      if (buf >= endp)
+        continue;
+      if (c < f.clrs) {
+        memcpy(buf, f.cmap + c * 3, 3);
+      } else {
+        buf[0] = buf[1] = buf[2] = 0;
+      }
+      buf[3] = T_NONE;
+    }
+  }
+}
+
+
+Fl_RGB_Image *Fl_Anim_GIF_Image::FrameInfo::frame_image(int frame) {
+  // return the composed image of a frame, compose it if needed
+  if (!lazy)
+    return frames[frame].rgb;
+  if (frames[frame].rgb) {
+    CacheMap::iterator it = cache_index.find(CacheKey(this, frame));
+    if (it != cache_index.end())
+      cache_lru.splice(cache_lru.begin(), cache_lru, it->second); // most recently used
+    return frames[frame].rgb;
+  }
+  DEBUG(("compose frame #%d\n", frame + 1));
+  size_t bytes = (size_t)data_w * data_h * 4;
+  uchar *buf = new uchar[bytes];
+  compose(frame, buf);
+  // evict other frames before adding this one, so this frame stays available
+  cache_evict(bytes);
+  frames[frame].rgb = new Fl_RGB_Image(buf, data_w, data_h, 4);
+  frames[frame].rgb->alloc_array = 1;
+  cache_lru.push_front(CacheKey(this, frame));
+  cache_index[CacheKey(this, frame)] = cache_lru.begin();
+  cache_bytes += bytes;
+  return frames[frame].rgb;
+}
+
+
 bool Fl_Anim_GIF_Image::FrameInfo::load(const char *name, const unsigned char *data, size_t length) {
   // decode using FLTK
   valid = false;
@@ -305,10 +530,12 @@ void Fl_Anim_GIF_Image::FrameInfo::on_frame_data(Fl_GIF_Image::GIF_FRAME &gf) {
   if (!gf.ifrm) {
     // first frame, get width/height
     valid = true; // may be reset later from loading callback
-    canvas_w = gf.width;
-    canvas_h = gf.height;
-    offscreen = new uchar[canvas_w * canvas_h * 4];
-    memset(offscreen, 0, canvas_w * canvas_h * 4);
+    canvas_w = data_w = gf.width;
+    canvas_h = data_h = gf.height;
+    if (!lazy) {
+      offscreen = new uchar[canvas_w * canvas_h * 4];
+      memset(offscreen, 0, canvas_w * canvas_h * 4);
+    }
   }
 
   if (!gf.ifrm) {
@@ -340,8 +567,35 @@ void Fl_Anim_GIF_Image::FrameInfo::on_frame_data(Fl_GIF_Image::GIF_FRAME &gf) {
     frame.x, frame.y, frame.w, frame.h,
     gf.delay, gf.dispose, gf.trans));
 
+  if (lazy) {
+    // keep the color indices and the palette, the frame is composed when shown
+    frame.rgb = 0;
+    frame.bits = new uchar[frame.w * frame.h];
+    memcpy(frame.bits, gf.bptr, frame.w * frame.h);
+    frame.clrs = gf.clrs;
+    frame.trans = gf.trans;
+    const GifFrame *last = frames_size ? &frames[frames_size - 1] : 0;
+    if (last && last->clrs == gf.clrs && !memcmp(last->cmap, gf.cpal, gf.clrs * 3)) {
+      frame.cmap = last->cmap; // typically the global color table
+      frame.own_cmap = false;
+    } else {
+      frame.cmap = new uchar[gf.clrs * 3];
+      memcpy(frame.cmap, gf.cpal, gf.clrs * 3);
+      frame.own_cmap = true;
+    }
+    if (!push_back_frame(frame)) {
+      delete[] frame.bits;
+      if (frame.own_cmap)
+        delete[] frame.cmap;
+      valid = false;
+    }
+    frame.bits = 0;
+    frame.cmap = 0;
+    return;
+  }
+
   // we know now everything we need about the frame..
-  dispose(frames_size - 1);
+  dispose(frames_size - 1, offscreen);
 
   // copy image data to offscreen
   const uchar *bits = gf.bptr;
@@ -419,6 +673,7 @@ void Fl_Anim_GIF_Image::FrameInfo::resize(int W, int H) {
 
 
 void Fl_Anim_GIF_Image::FrameInfo::scale_frame(int frame) {
+  frame_image(frame); // compose now if needed
   // Do the actual scaling after a resize if neccessary
   int new_w = optimize_mem ? frames[frame].w : canvas_w;
   int new_h = optimize_mem ? frames[frame].h : canvas_h;
@@ -437,7 +692,7 @@ void Fl_Anim_GIF_Image::FrameInfo::scale_frame(int frame) {
 }
 
 
-void Fl_Anim_GIF_Image::FrameInfo::set_to_background(int frame) {
+void Fl_Anim_GIF_Image::FrameInfo::set_to_background(int frame, uchar *dst) {
   // reset offscreen to background color
   int bg = background_color_index;
   int tp = frame >= 0 ? frames[frame].transparent_color_index : bg;
@@ -449,7 +704,7 @@ void Fl_Anim_GIF_Image::FrameInfo::set_to_background(int frame) {
     bg = tp;
   color.alpha = tp == bg ? T_FULL : tp < 0 ? T_FULL : T_NONE;
   DEBUG(("  set to color %d/%d/%d alpha=%d\n", color.r, color.g, color.b, color.alpha));
-  for (uchar *p = offscreen + canvas_w * canvas_h * 4 - 4; p >= offscreen; p -= 4)
+  for (uchar *p = dst + data_w * data_h * 4 - 4; p >= dst; p -= 4)
     memcpy(p, &color, 4);
 }
 
@@ -531,10 +786,13 @@ Fl_Anim_GIF_Image::Fl_Anim_GIF_Image(const char *filename,
   valid_(false),
   frame_(-1),
   speed_(1.),
-  fi_(new FrameInfo(this))
+  fi_(new FrameInfo(this)),
+  timer_(0),
+  paused_(false)
 {
   fi_->debug_ = ((flags_ & LOG_FLAG) != 0) + 2 * ((flags_ & DEBUG_FLAG) != 0);
-  fi_->optimize_mem = (flags_ & OPTIMIZE_MEMORY);
+  fi_->lazy = (flags_ & LAZY_DECODE) != 0;
+  fi_->optimize_mem = (flags_ & OPTIMIZE_MEMORY) && !fi_->lazy;
   valid_ = load(filename, NULL, 0);
   if (canvas_w() && canvas_h()) {
     if (!w() && !h()) {
@@ -580,10 +838,13 @@ Fl_Anim_GIF_Image::Fl_Anim_GIF_Image(const char* imagename, const unsigned char
   valid_(false),
   frame_(-1),
   speed_(1.),
-  fi_(new FrameInfo(this))
+  fi_(new FrameInfo(this)),
+  timer_(0),
+  paused_(false)
 {
   fi_->debug_ = ((flags_ & LOG_FLAG) != 0) + 2 * ((flags_ & DEBUG_FLAG) != 0);
-  fi_->optimize_mem = (flags_ & OPTIMIZE_MEMORY);
+  fi_->lazy = (flags_ & LAZY_DECODE) != 0;
+  fi_->optimize_mem = (flags_ & OPTIMIZE_MEMORY) && !fi_->lazy;
   valid_ = load(imagename, data, length);
   if (canvas_w() && canvas_h()) {
     if (!w() && !h()) {
@@ -609,7 +870,9 @@ Fl_Anim_GIF_Image::Fl_Anim_GIF_Image() :
   valid_(false),
   frame_(-1),
   speed_(1.),
-  fi_(new FrameInfo(this)) {
+  fi_(new FrameInfo(this)),
+  timer_(0),
+  paused_(false) {
 }
 
 
@@ -618,7 +881,7 @@ Fl_Anim_GIF_Image::Fl_Anim_GIF_Image() :
  Also removes the animation timer.
  */
 Fl_Anim_GIF_Image::~Fl_Anim_GIF_Image() /* override */ {
-  Fl::remove_timeout(cb_animate, this);
+  unschedule_();
   delete fi_;
   free(name_);
 }
@@ -652,8 +915,8 @@ void Fl_Anim_GIF_Image::canvas(Fl_Widget *canvas, unsigned short flags/* = 0*/)
   // Note: 'Start' flag is *NOT* used here,
   //       but an already running animation is restarted.
   frame_ = -1;
-  if (Fl::has_timeout(cb_animate, this)) {
-    Fl::remove_timeout(cb_animate, this);
+  if (scheduled_()) {
+    unschedule_();
     next_frame();
   }
   else if ( fi_->frames_size ) {
@@ -689,7 +952,7 @@ int Fl_Anim_GIF_Image::canvas_h() const {
 /*static*/
 void Fl_Anim_GIF_Image::cb_animate(void *d) {
   Fl_Anim_GIF_Image *b = (Fl_Anim_GIF_Image *)d;
-  b->next_frame();
+  b->tick_();
 }
 
 
@@ -712,10 +975,12 @@ void Fl_Anim_GIF_Image::color_average(Fl_Color c, float i) /* override */ {
   if (i < 0) {
     // immediate mode
     i = -i;
-    for (int f=0; f < frames(); f++) {
-      fi_->frames[f].rgb->color_average(c, i);
+    if (!fi_->lazy) { // lazily decoded frames are averaged when they are shown
+      for (int f=0; f < frames(); f++) {
+        fi_->frames[f].rgb->color_average(c, i);
+      }
+      return;
     }
-    return;
   }
   fi_->average_color = c;
   fi_->average_weight = i;
@@ -737,14 +1002,12 @@ void Fl_Anim_GIF_Image::color_average(Fl_Color c, float i) /* override */ {
  */
 Fl_Image *Fl_Anim_GIF_Image::copy(int W, int H) const /* override */ {
   Fl_Anim_GIF_Image *copied = new Fl_Anim_GIF_Image();
-  // copy/resize the base image (Fl_Pixmap)
+  // copy/resize the base image (Fl_GIF_Image)
   // Note: this is not really necessary, if the draw()
   //       method never calls the base class.
   if (fi_->frames_size) {
-    Fl_Pixmap *gif = (Fl_Pixmap *)Fl_GIF_Image::copy(W, H);
-    copied->Fl_GIF_Image::data(gif->data(), gif->count());
-    copied->alloc_data = gif->alloc_data;
-    gif->alloc_data = 0;
+    Fl_GIF_Image *gif = (Fl_GIF_Image *)Fl_GIF_Image::copy(W, H);
+    copied->take_image_(gif);
     delete gif;
   }
 
@@ -762,7 +1025,7 @@ Fl_Image *Fl_Anim_GIF_Image::copy(int W, int H) const /* override */ {
   copied->uncache_ = uncache_; // copy 'inherits' frame uncache status
   copied->valid_ = valid_ && copied->fi_->frames_size == fi_->frames_size;
   copied->scale_frame(); // scale current frame now
-  if (copied->valid_ && frame_ >= 0 && !Fl::has_timeout(cb_animate, copied))
+  if (copied->valid_ && frame_ >= 0 && !copied->scheduled_())
     copied->start(); // start if original also was started
   return copied;
 }
@@ -811,6 +1074,13 @@ void Fl_Anim_GIF_Image::desaturate() /* override */ {
  */
 void Fl_Anim_GIF_Image::draw(int x, int y, int w, int h,
                              int cx/* = 0*/, int cy/* = 0*/) /* override */ {
+  if (paused_) {
+    // the animation was paused while its canvas was hidden
+    paused_ = false;
+    double delay = frame_delay_(frame_);
+    if (delay > 0)
+      schedule_(delay);
+  }
   if (this->image()) {
     if (fi_->optimize_mem) {
       int f0 = frame_;
@@ -856,7 +1126,7 @@ int Fl_Anim_GIF_Image::frame() const {
  \param[in] frame index into list of frames
  */
 void Fl_Anim_GIF_Image::frame(int frame) {
-  if (Fl::has_timeout(cb_animate, this)) {
+  if (scheduled_()) {
     Fl::warning("Fl_Anim_GIF_Image::frame(%d): not idle!\n", frame);
     return;
   }
@@ -892,6 +1162,7 @@ void Fl_Anim_GIF_Image::frame(int frame) {
  */
 int Fl_Anim_GIF_Image::frame_count(const char *name, const unsigned char *imgdata /* = NULL */, size_t imglength /* = 0 */) {
   Fl_Anim_GIF_Image temp;
+  temp.fi_->lazy = true; // no need to compose the frames
   temp.load(name, imgdata, imglength);
   int frames = temp.valid() ? temp.frames() : 0;
   return frames;
@@ -993,18 +1264,24 @@ int Fl_Anim_GIF_Image::frames() const {
  \return a pointer to the image or NULL if this is not an animation.
  */
 Fl_Image *Fl_Anim_GIF_Image::image() const {
-  return frame_ >= 0 && frame_ < frames() ? fi_->frames[frame_].rgb : 0;
+  return image(frame_);
 }
 
 
 /** Return the image of the given frame index.
 
+ With \ref LAZY_DECODE the frame is composed if needed, and the returned
+ image may be released when other frames are composed later.
+
  \param[in] frame_ index into list of frames
  \return image data or NULL if the frame number is not valid.
  */
 Fl_Image *Fl_Anim_GIF_Image::image(int frame_) const {
-  if (frame_ >= 0 && frame_ < frames())
+  if (frame_ >= 0 && frame_ < frames()) {
+    if (fi_->lazy)
+      fi_->set_frame(frame_); // compose and apply pending color changes
     return fi_->frames[frame_].rgb;
+  }
   return 0;
 }
 
@@ -1061,6 +1338,8 @@ bool Fl_Anim_GIF_Image::load(const char *name, const unsigned char *imgdata /* =
     delete[] (char **)data();
   }
   alloc_data = 0;
+  delete rgb_;
+  rgb_ = NULL;
   w(0);
   h(0);
 
@@ -1105,16 +1384,59 @@ bool Fl_Anim_GIF_Image::next_frame() {
   if (frame >= fi_->frames_size)
     return false;
   set_frame(frame);
+  double delay = frame_delay_(frame);
+  if (delay > 0)
+    schedule_(delay);
+  return true;
+}
+
+
+// Return the playback delay of a frame in seconds, or 0 if the
+// animation should not continue after this frame.
+double Fl_Anim_GIF_Image::frame_delay_(int frame) const {
+  if (frame < 0 || frame >= fi_->frames_size)
+    return 0.;
   double delay = fi_->frames[frame].delay;
   if (min_delay && delay < min_delay) {
     DEBUG(("#%d: correct delay %f => %f\n", frame, delay, min_delay));
     delay = min_delay;
   }
-  if (is_animated() && delay > 0 && speed_ > 0) {  // normal GIF has no delay
-    delay /= speed_;
-    Fl::add_timeout(delay, cb_animate, this);
+  if (is_animated() && delay > 0 && speed_ > 0)  // normal GIF has no delay
+    return delay / speed_;
+  return 0.;
+}
+
+
+// Advance the animation when its timer expires, or pause it while its canvas
+// is hidden. A paused animation is resumed when it is drawn again.
+void Fl_Anim_GIF_Image::tick_() {
+  if ((flags_ & AUTO_PAUSE) && canvas_ && !canvas_->visible_r()) {
+    DEBUG(("canvas hidden - paused at frame %d\n", frame_ + 1));
+    paused_ = true;
+    return;
   }
-  return true;
+  next_frame();
+}
+
+
+void Fl_Anim_GIF_Image::schedule_(double delay) {
+  if (flags_ & SHARED_TIMER)
+    Timer::add(this, delay);
+  else
+    Fl::add_timeout(delay, cb_animate, this);
+}
+
+
+void Fl_Anim_GIF_Image::unschedule_() {
+  Fl::remove_timeout(cb_animate, this);
+  if (timer_)
+    timer_->remove(this);
+  paused_ = false;
+}
+
+
+bool Fl_Anim_GIF_Image::scheduled_() const {
+  return paused_ || timer_ || Fl::has_timeout(cb_animate, (void *)this);
 }
 
 
@@ -1188,8 +1510,8 @@ void Fl_Anim_GIF_Image::set_frame(int frame) {
 //  int last_frame = frame_;
   frame_ = frame;
   // NOTE: uncaching decreases performance, but saves a lot of memory
-  if (uncache_ && this->image())
-    this->image()->uncache();
+  if (uncache_ && fi_->frames[frame_].rgb)
+    fi_->frames[frame_].rgb->uncache();
 
   fi_->set_frame(frame_);
 
@@ -1243,7 +1565,7 @@ void Fl_Anim_GIF_Image::speed(double speed) {
  \return true if the animation has frames
  */
 bool Fl_Anim_GIF_Image::start() {
-  Fl::remove_timeout(cb_animate, this);
+  unschedule_();
   if (fi_->frames_size) {
     next_frame();
   }
@@ -1255,7 +1577,7 @@ bool Fl_Anim_GIF_Image::start() {
  \return true if the animation has frames
  */
 bool Fl_Anim_GIF_Image::stop() {
-  Fl::remove_timeout(cb_animate, this);
+  unschedule_();
   return fi_->frames_size != 0;
 }
 
@@ -1264,7 +1586,7 @@ bool Fl_Anim_GIF_Image::stop() {
  \return true if the animation has frames
  */
 bool Fl_Anim_GIF_Image::next() {
-  if (fi_->frames_size && !(Fl::has_timeout(cb_animate, this))) {
+  if (fi_->frames_size && !scheduled_()) {
     int f = frame() + 1;
     if (f >= frames()) f = 0;
     frame(f);
@@ -1273,6 +1595,43 @@ bool Fl_Anim_GIF_Image::next() {
 }
 
 
+/** Return if the animation is currently running or stopped.
+
+ An animation that was paused because its canvas is hidden (see
+ \ref AUTO_PAUSE) counts as running.
+ \return true if the animation is running
+ */
+bool Fl_Anim_GIF_Image::playing() const {
+  return valid() && scheduled_();
+}
+
+
+/** Set the memory limit for composed frames of lazily decoded animations.
+
+ Animations loaded with the \ref LAZY_DECODE flag compose their frames when
+ they are shown. The composed frames of all such animations are kept until
+ their total size exceeds this limit, then the least recently shown frames
+ are released. The default is 16 MB.
+
+ \param[in] bytes new limit in bytes
+ \since 1.5.0
+ */
+void Fl_Anim_GIF_Image::frame_cache_size(size_t bytes) {
+  FrameInfo::cache_limit = bytes;
+  FrameInfo::cache_evict(0);
+}
+
+
+/** Return the memory limit for composed frames of lazily decoded animations.
+ \return the limit in bytes
+ \see frame_cache_size(size_t)
+ \since 1.5.0
+ */
+size_t Fl_Anim_GIF_Image::frame_cache_size() {
+  return FrameInfo::cache_limit;
+}
+
+
 /** Uncache all cached image data now.
  Re-implemented from Fl_Pixmap.
  */
@@ -1291,3 +1650,51 @@ void Fl_Anim_GIF_Image::uncache() /* override */ {
 bool Fl_Anim_GIF_Image::valid() const {
   return valid_;
 }
+
+
+//
+// helper class Timer implementation
+//
+
+/*static*/
+void Fl_Anim_GIF_Image::Timer::add(Fl_Anim_GIF_Image *anim, double delay) {
+  Timer *t;
+  std::map<double, Timer *>::iterator it = timers.find(delay);
+  if (it != timers.end()) {
+    t = it->second;
+  } else {
+    t = new Timer(delay);
+    timers[delay] = t;
+    Fl::add_timeout(delay, cb_tick, t);
+  }
+  t->waiting.push_back(anim);
+  anim->timer_ = t;
+}
+
+
+void Fl_Anim_GIF_Image::Timer::remove(Fl_Anim_GIF_Image *anim) {
+  waiting.erase(std::remove(waiting.begin(), waiting.end(), anim), waiting.end());
+  firing.erase(std::remove(firing.begin(), firing.end(), anim), firing.end());
+  anim->timer_ = 0;
+}
+
+
+/*static*/
+void Fl_Anim_GIF_Image::Timer::cb_tick(void *d) {
+  Timer *t = (Timer *)d;
+  // animations that schedule their next frame with the same delay
+  // are added to 'waiting' again while we advance them
+  t->firing.swap(t->waiting);
+  while (!t->firing.empty()) {
+    Fl_Anim_GIF_Image *anim = t->firing.back();
+    t->firing.pop_back();
+    anim->timer_ = 0;
+    anim->tick_();
+  }
+  if (t->waiting.empty()) {
+    timers.erase(t->delay);
+    delete t;
+  } else {
+    Fl::repeat_timeout(t->delay, cb_tick, t);
+  }
+}
@@ -59,6 +59,11 @@
 #  error Cairo is not supported on this platform.
 #endif
 
+#if defined(FLTK_USE_HEADLESS)
+#  include <FL/headless.H>
+#  include "drivers/Headless/Fl_Headless_Window_Driver.H"
+#endif
+
 // static initialization
 
 Fl_Cairo_State Fl::Private::cairo_state_; ///< current Cairo context information
@@ -158,6 +163,17 @@ cairo_t *Fl::cairo_make_current(Fl_Window *wi) {
   }
 #endif
 
+#if defined(FLTK_USE_HEADLESS)
+  if (fl_headless_backend()) { // windows are drawn into Cairo image buffers
+    struct Fl_Headless_Window_Driver::raster *r = Fl_Headless_Window_Driver::raster(wi);
+    if (!r || !r->buffer.buffer)
+      return NULL; // the window is not shown or not drawn yet
+    cairo_ctxt = r->buffer.cairo_;
+    Fl::Private::cairo_state_.cc(cairo_ctxt, false);
+    return cairo_ctxt;
+  }
+#endif
+
   if (fl_gc == 0) {  // means remove current cc
     Fl::cairo_cc(0); // destroy any previous cc
     Fl::Private::cairo_state_.window(0);
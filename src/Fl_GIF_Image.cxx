@@ -30,6 +30,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_GIF_Image.H>
+#include <FL/Fl_RGB_Image.H>
 #include "Fl_Image_Reader.h"
 #include <FL/fl_utf8.h>
 #include "flstring.h"
@@ -131,7 +132,8 @@ static int gif_error(Fl_Image_Reader &rdr, int line, uchar *Image) {
   \see Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data, const long length)
 */
 Fl_GIF_Image::Fl_GIF_Image(const char *filename) :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
   Fl_Image_Reader rdr;
   if (rdr.open(filename) == -1) {
@@ -174,7 +176,8 @@ Fl_GIF_Image::Fl_GIF_Image(const char *filename) :
   \since 1.4.0
 */
 Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data, const size_t length) :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
   Fl_Image_Reader rdr;
   if (rdr.open(imagename, data, length) == -1) {
@@ -205,7 +208,8 @@ Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data, con
   \see Fl_GIF_Image(const char *imagename, const unsigned char *data, const size_t length)
 */
 Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data) :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
   Fl_Image_Reader rdr;
   if (rdr.open(imagename, data) == -1) {
@@ -216,7 +220,8 @@ Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data) :
 }
 
 Fl_GIF_Image::Fl_GIF_Image(const char *filename, bool anim) :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
   Fl_Image_Reader rdr;
   if (rdr.open(filename) == -1) {
@@ -228,7 +233,8 @@ Fl_GIF_Image::Fl_GIF_Image(const char *filename, bool anim) :
 }
 
 Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data, const size_t length, bool anim) :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
   Fl_Image_Reader rdr;
   if (rdr.open(imagename, data, length) == -1) {
@@ -243,10 +249,89 @@ Fl_GIF_Image::Fl_GIF_Image(const char *imagename, const unsigned char *data, con
 
 */
 Fl_GIF_Image::Fl_GIF_Image() :
-  Fl_Pixmap((char *const*)0)
+  Fl_Pixmap((char *const*)0),
+  rgb_(0)
 {
 }
 
+bool Fl_GIF_Image::decode_rgb = false;
+
+/**
+  The destructor frees all memory and server resources that are used by
+  the image.
+*/
+Fl_GIF_Image::~Fl_GIF_Image() {
+  delete rgb_;
+}
+
+/*
+  Moves the image data of 'src' (XPM or RGB data) to this image.
+  Used by Fl_Anim_GIF_Image::copy().
+*/
+void Fl_GIF_Image::take_image_(Fl_GIF_Image *src) {
+  if (src->rgb_) {
+    rgb_ = src->rgb_;
+    src->rgb_ = NULL;
+  } else {
+    data(src->data(), src->count());
+    alloc_data = src->alloc_data;
+    src->alloc_data = 0;
+  }
+}
+
+// The following methods use the RGB image if the GIF file was
+// decoded directly to RGB data, and Fl_Pixmap's methods otherwise.
+
+Fl_Image *Fl_GIF_Image::copy(int W, int H) const {
+  Fl_GIF_Image *gif = new Fl_GIF_Image();
+  if (rgb_) {
+    gif->rgb_ = (Fl_RGB_Image *)rgb_->copy(W, H);
+    gif->w(W);
+    gif->h(H);
+    gif->d(1);
+  } else {
+    Fl_Pixmap *pxm = (Fl_Pixmap *)Fl_Pixmap::copy(W, H);
+    gif->data(pxm->data(), pxm->count());
+    gif->alloc_data = pxm->alloc_data;
+    pxm->alloc_data = 0;
+    gif->w(pxm->w());
+    gif->h(pxm->h());
+    gif->d(pxm->d());
+    delete pxm;
+  }
+  return gif;
+}
+
+void Fl_GIF_Image::color_average(Fl_Color c, float i) {
+  if (!rgb_) {
+    Fl_Pixmap::color_average(c, i);
+    return;
+  }
+  rgb_->color_average(c, i);
+}
+
+void Fl_GIF_Image::desaturate() {
+  if (!rgb_) {
+    Fl_Pixmap::desaturate();
+    return;
+  }
+  rgb_->desaturate();
+}
+
+void Fl_GIF_Image::draw(int X, int Y, int W, int H, int cx, int cy) {
+  if (!rgb_) {
+    Fl_Pixmap::draw(X, Y, W, H, cx, cy);
+    return;
+  }
+  rgb_->scale(w(), h(), 0, 1);
+  rgb_->draw(X, Y, W, H, cx, cy);
+}
+
+void Fl_GIF_Image::uncache() {
+  Fl_Pixmap::uncache();
+  if (rgb_) rgb_->uncache();
+}
+
 
 /*
   Internally used method to read from the LZW compressed data
@@ -467,6 +552,34 @@ static char ** convert_to_xpm(uchar *Image, int Width, int Height, ColorMap &CMa
 }
 
 
+/*
+  Internally used function to convert raw 'Image' data to an RGB image,
+  or an RGBA image if 'transparent_pixel' is used in the image.
+  This is used instead of convert_to_xpm() if Fl_GIF_Image::decode_rgb is
+  set and by Fl_Anim_GIF_Image.
+*/
+static Fl_RGB_Image *convert_to_rgb(const uchar *Image, int Width, int Height, const ColorMap &CMap, int transparent_pixel) {
+  int depth = 3;
+  const uchar *p, *end = Image + Width*Height;
+  if (transparent_pixel >= 0) {
+    for (p = Image; p < end; p++) {
+      if (*p == transparent_pixel) { depth = 4; break; }
+    }
+  }
+  uchar *rgb = new uchar[Width*Height*depth];
+  uchar *q = rgb;
+  for (p = Image; p < end; p++) {
+    *q++ = CMap.Red[*p];
+    *q++ = CMap.Green[*p];
+    *q++ = CMap.Blue[*p];
+    if (depth == 4) *q++ = (*p == transparent_pixel) ? 0 : 255;
+  }
+  Fl_RGB_Image *img = new Fl_RGB_Image(rgb, Width, Height, depth);
+  img->alloc_array = 1;
+  return img;
+}
+
+
 /*
   This method reads GIF image data and creates an RGB or RGBA image. The GIF
   format supports only 1 bit for alpha. The final image data is stored in
@@ -479,8 +592,10 @@ static char ** convert_to_xpm(uchar *Image, int Width, int Height, ColorMap &CMa
   image is decoded (as with Fl_GIF_Image), but all contained images are read.
   The new Fl_Anim_GIF_Image class is derived from Fl_GIF_Image and utilises this
   feature in order to avoid code duplication of the GIF decoding routines.
-  The first image is in this case (additionally) stored in the usual way as described
-  above (making the Fl_Anim_GIF_Image a normal Fl_GIF_Image too).
+  The first image is in this case (additionally) stored as an Fl_RGB_Image
+  (making the Fl_Anim_GIF_Image a normal Fl_GIF_Image too).
+  If Fl_GIF_Image::decode_rgb is set, the first image of an Fl_GIF_Image is also
+  converted directly to an Fl_RGB_Image rather than to XPM data.
   All subsequent images are only decoded (and not converted to XPM) and passed
   to Fl_Anim_GIF_Image, which stores them on its own (in RGBA format).
 */
@@ -731,18 +846,20 @@ void Fl_GIF_Image::load_gif_(Fl_Image_Reader &rdr, bool anim/*=false*/)
             uchar *dst = moved_image + y*ScreenWidth + xstart;
             memcpy(dst, src, xmax-xstart);
           }
-          char **new_data = convert_to_xpm(moved_image, ScreenWidth, ScreenHeight, CMap, ColorMapSize, has_transparent ? transparent_pixel : -1);
-          data((const char **)new_data, Height + 2);
-          alloc_data = 1;
+          rgb_ = convert_to_rgb(moved_image, ScreenWidth, ScreenHeight, CMap, has_transparent ? transparent_pixel : -1);
           delete[] moved_image;
         } else {
           // Fl_GIF_Image does not apply offsets and just show the first frame at 0, 0
           w(Width);
           h(Height);
           d(1);
-          char **new_data = convert_to_xpm(Image, Width, Height, CMap, ColorMapSize, has_transparent ? transparent_pixel : -1);
-          data((const char **)new_data, Height + 2);
-          alloc_data = 1;
+          if (anim || decode_rgb) {
+            rgb_ = convert_to_rgb(Image, Width, Height, CMap, has_transparent ? transparent_pixel : -1);
+          } else {
+            char **new_data = convert_to_xpm(Image, Width, Height, CMap, ColorMapSize, has_transparent ? transparent_pixel : -1);
+            data((const char **)new_data, Height + 2);
+            alloc_data = 1;
+          }
         }
       }
 
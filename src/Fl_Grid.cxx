@@ -30,12 +30,16 @@
 class Fl_Grid::Col {
   friend class Fl_Grid;
   int minw_;            // minimal size (width)
+  int cminw_;           // minimal size including widgets, see calc_sizes()
   int w_;               // calculated size (width)
+  int x_;               // calculated position relative to the first column
   short weight_;        // weight used to allocate extra space
   short gap_;           // gap to the right of the column
   Col() {
     minw_   =  0;
+    cminw_  =  0;
     w_      =  0;
+    x_      =  0;
     weight_ = 50;
     gap_    = -1;
   }
@@ -49,6 +53,7 @@ class Fl_Grid::Row {
 
   Cell *cells_;         // cells of this row
   int minh_;            // minimal size (height)
+  int cminh_;           // minimal size including widgets, see calc_sizes()
   int h_;               // calculated size (height)
   short weight_;        // weight used to allocate extra space
   short gap_;           // gap below the row (-1 = use default)
@@ -56,6 +61,7 @@ class Fl_Grid::Row {
   Row() {
     cells_  = NULL;
     minh_   =  0;
+    cminh_  =  0;
     h_      =  0;
     weight_ = 50;
     gap_    = -1;
@@ -128,6 +134,8 @@ void Fl_Grid::init() {
   Rows_ = 0;
   old_size = Fl_Rect(0, 0, 0, 0);
   need_layout_ = false;               // no need to calculate layout
+  need_sizes_ = true;
+  resizing_ = false;
   grid_color = (Fl_Color)0xbbeebb00;  // light green
   draw_grid_ = false;                 // don't draw grid helper lines
   if (fl_getenv("FLTK_GRID_DEBUG"))
@@ -316,6 +324,34 @@ void Fl_Grid::draw() {
 
 } // Fl_Grid::draw()
 
+// private: calculate the minimal column widths and row heights
+
+void Fl_Grid::calc_sizes() {
+
+  Col *col = Cols_;
+  for (int c = 0; c < cols_; c++, col++) {
+    col->cminw_ = col->minw_;
+  }
+
+  Row *row = Rows_;
+  for (int r = 0; r < rows_; r++, row++) {
+    row->cminh_ = row->minh_;
+    for (Cell *cel = row->cells_; cel; cel = cel->next_) {
+      Fl_Widget *wi = cel->widget_;
+      cel->visible_ = (wi && wi->visible());
+      cel->changed_ = false;
+      if (cel->visible_) {
+        col = &Cols_[cel->col_];
+        if (cel->colspan_ == 1 && cel->w_ > col->cminw_) col->cminw_ = cel->w_;
+        if (cel->rowspan_ == 1 && cel->h_ > row->cminh_) row->cminh_ = cel->h_;
+      } // widget
+    } // cells
+  } // rows
+
+  need_sizes_ = false;
+
+} // calc_sizes()
+
 /**
   Calculate the grid layout and resize and position all widgets.
 
@@ -324,6 +360,10 @@ void Fl_Grid::draw() {
 
   Calling it once after all modifications are completed is enough.
 
+  When called by resize() the minimal column widths and row heights of
+  the previous layout are used unless a method of Fl_Grid changed the
+  layout, a cell was changed, or a widget was shown or hidden.
+
   \todo Document when and why to call layout() w/o args. See Fl_Flex::layout()
 
   \see Fl_Grid::layout(int rows, int cols, int margin, int gap)
@@ -337,40 +377,29 @@ void Fl_Grid::layout() {
   Col *col;
   Cell *cel;
 
+  if (!resizing_)
+    need_sizes_ = true;
+
   // calculate the total available space w/o borders and margins
 
   int tw = w() - Fl::box_dw(box()) - margin_left_ - margin_right_;
   int th = h() - Fl::box_dh(box()) - margin_top_ - margin_bottom_;
 
+  if (need_sizes_)
+    calc_sizes();
+
   // initialize column widths and row heights
 
   col = Cols_;
   for (int c = 0; c < cols_; c++, col++) {
-    col->w_ = col->minw_;
+    col->w_ = col->cminw_;
   }
 
   row = Rows_;
   for (int r = 0; r < rows_; r++, row++) {
-    row->h_ = row->minh_;
+    row->h_ = row->cminh_;
   }
 
-  // calculate minimal column widths and row heights (in one loop)
-
-  row = Rows_;
-  for (int r = 0; r < rows_; r++, row++) {
-    col = Cols_;
-    for (int c = 0; c < cols_; c++, col++) {
-      cel = cell(r, c);
-      if (cel) {
-        Fl_Widget *wi = cel->widget_;
-        if (wi && wi->visible()) {
-          if (cel->colspan_ == 1 && cel->w_ > col->w_) col->w_ = cel->w_;
-          if (cel->rowspan_ == 1 && cel->h_ > row->h_) row->h_ = cel->h_;
-        } // widget
-      } // colspan && rowspan
-    } // cols
-  } // rows
-
   // calculate total space occupied by rows and columns including gaps
 
   int tcwi = 0;       // total column width incl. gaps
@@ -444,77 +473,86 @@ void Fl_Grid::layout() {
       Rows_[irwe].h_ += remaining;
   }
 
-  // calculate and assign widget positions and sizes
+  // calculate column positions
 
-  int x0, y0; // starting x/y positions
+  int x0 = 0;
+  col = Cols_;
+  for (int c = 0; c < cols_; c++, col++) {
+    col->x_ = x0;
+    x0 += (col->w_ + ((col->gap_ >= 0) ? col->gap_ : gap_col_));
+  }
 
-  y0 = y() + Fl::box_dy(box()) + margin_top_;
+  // calculate and assign widget positions and sizes
+
+  int xs = x() + Fl::box_dx(box()) + margin_left_;
+  int y0 = y() + Fl::box_dy(box()) + margin_top_;
 
   row = Rows_;
   for (int r = 0; r < rows_; r++, row++) {
-    x0 = x() + Fl::box_dx(box()) + margin_left_;
-    col = Cols_;
-    for (int c = 0; c < cols_; c++, col++) {
-      int wx = x0;  // widget's x
-      int wy = y0;  // widget's y
-      cel = cell(r, c);
-      if (cel) {
-        Fl_Widget *wi = cel->widget_;
-        if (wi && wi->visible()) {
-
-          // calculate the cell's position and size, take cell spanning into account
-
-          int ww = col->w_;
-          int wh = row->h_;
-
-          for (int i = 0; i < cel->colspan_ - 1; i++) {
-            ww += (Cols_[c + i].gap_ >= 0) ? Cols_[c + i].gap_ : gap_col_;
-            ww += Cols_[c + i + 1].w_;
-          }
-
-          for (int i = 0; i < cel->rowspan_ - 1; i++) {
-            wh += (Rows_[r + i].gap_ >= 0) ? Rows_[r + i].gap_ : gap_row_;
-            wh += Rows_[r + i + 1].h_;
-          }
-
-          // horizontal alignment: left + right => stretch
-
-          Fl_Grid_Align ali = cel->align_;
-          Fl_Grid_Align mask;
-
-          mask = FL_GRID_LEFT | FL_GRID_RIGHT | FL_GRID_HORIZONTAL;
-          if ((ali & mask) == 0) {
-            wx += (ww - cel->w_) / 2;
-            ww = cel->w_;
-          } else if ((ali & mask) == FL_GRID_LEFT) {
-            ww = cel->w_;
-          } else if ((ali & mask) == FL_GRID_RIGHT) {
-            wx += ww - cel->w_;
-            ww = cel->w_;
-          }
-
-          // vertical alignment: top + bottom => stretch
-
-          mask = FL_GRID_TOP | FL_GRID_BOTTOM | FL_GRID_VERTICAL;
-          if ((ali & mask) == 0) {
-            wy += (wh - cel->h_) / 2;
-            wh = cel->h_;
-          } else if ((ali & mask) == FL_GRID_TOP) {
-            wh = cel->h_;
-          } else if ((ali & mask) == FL_GRID_BOTTOM) {
-            wy += wh - cel->h_;
-            wh = cel->h_;
-          }
+    for (cel = row->cells_; cel; cel = cel->next_) {
+      Fl_Widget *wi = cel->widget_;
+      if ((wi && wi->visible()) != cel->visible_ || cel->changed_) {
+        need_sizes_ = true; // shown, hidden, or changed: start over
+        layout();
+        return;
+      }
+      if (cel->visible_) {
+        int c = cel->col_;
+        col = &Cols_[c];
+        int wx = xs + col->x_;  // widget's x
+        int wy = y0;            // widget's y
 
-          wi->resize(wx, wy, ww, wh);
+        // calculate the cell's position and size, take cell spanning into account
 
-        } // widget is visible
+        int ww = col->w_;
+        int wh = row->h_;
 
-      } // cell
+        for (int i = 0; i < cel->colspan_ - 1; i++) {
+          ww += (Cols_[c + i].gap_ >= 0) ? Cols_[c + i].gap_ : gap_col_;
+          ww += Cols_[c + i + 1].w_;
+        }
+
+        for (int i = 0; i < cel->rowspan_ - 1; i++) {
+          wh += (Rows_[r + i].gap_ >= 0) ? Rows_[r + i].gap_ : gap_row_;
+          wh += Rows_[r + i + 1].h_;
+        }
+
+        // horizontal alignment: left + right => stretch
+
+        Fl_Grid_Align ali = cel->align_;
+        Fl_Grid_Align mask;
+
+        mask = FL_GRID_LEFT | FL_GRID_RIGHT | FL_GRID_HORIZONTAL;
+        if ((ali & mask) == 0) {
+          wx += (ww - cel->w_) / 2;
+          ww = cel->w_;
+        } else if ((ali & mask) == FL_GRID_LEFT) {
+          ww = cel->w_;
+        } else if ((ali & mask) == FL_GRID_RIGHT) {
+          wx += ww - cel->w_;
+          ww = cel->w_;
+        }
+
+        // vertical alignment: top + bottom => stretch
+
+        mask = FL_GRID_TOP | FL_GRID_BOTTOM | FL_GRID_VERTICAL;
+        if ((ali & mask) == 0) {
+          wy += (wh - cel->h_) / 2;
+          wh = cel->h_;
+        } else if ((ali & mask) == FL_GRID_TOP) {
+          wh = cel->h_;
+        } else if ((ali & mask) == FL_GRID_BOTTOM) {
+          wy += wh - cel->h_;
+          wh = cel->h_;
+        }
+
+        // widgets that keep their place don't need to be resized
+        if (wx != wi->x() || wy != wi->y() || ww != wi->w() || wh != wi->h())
+          wi->resize(wx, wy, ww, wh);
 
-      x0 += (col->w_ + ((col->gap_ >= 0) ? col->gap_ : gap_col_));
+      } // widget is visible
 
-    } // cols
+    } // cells
 
     y0 += ( row->h_ + ((row->gap_ >= 0) ? row->gap_ : gap_row_) );
 
@@ -587,7 +625,9 @@ void Fl_Grid::remove_cell(int row, int col) {
 void Fl_Grid::resize(int X, int Y, int W, int H) {
   old_size = Fl_Rect(x(), y(), w(), h());
   Fl_Widget::resize(X, Y, W, H);
+  resizing_ = true;   // keep the minimal sizes, see layout()
   layout();
+  resizing_ = false;
 }
 
 /**
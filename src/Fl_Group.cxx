@@ -26,9 +26,152 @@
 #include <FL/fl_draw.H>
 
 #include <stdlib.h> // malloc etc.
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
 
 Fl_Group* Fl_Group::current_;
 
+// A grid of square cells, each with a list of the children that overlap it,
+// see Fl_Group::spatial_index(int). Children are entered with the position
+// they had when they were added or resized, minus the offset of the index,
+// so that moving all children by the same amount only changes the offset.
+class Fl_Group::Spatial_Index {
+public:
+  struct Entry {
+    int x, y, w, h;     // position and size, without offset
+    int c0, r0, c1, r1; // cells covered by the child, c0 > c1 for entries in large
+    int order;          // increases with the index of the child
+  };
+  std::unordered_map<const Fl_Widget*, Entry> entries;
+  std::unordered_map<long long, std::vector<Fl_Widget*> > cells;
+  std::vector<Fl_Widget*> large; // children that cover many cells or have outside labels
+  int cell;                      // width and height of a cell
+  int dx, dy;                    // offset of all entries
+  int bx, by, br, bb;            // bounding box of all entries, without offset
+  int next_order;
+  bool order_valid;              // false if order doesn't follow the children anymore
+  size_t built;                  // number of entries when cell was chosen
+
+  static int div(int v, int d) { return v >= 0 ? v / d : -((-v - 1) / d) - 1; }
+  static long long key(int c, int r) { return ((long long)c << 32) ^ (unsigned)r; }
+
+  void build(const Fl_Group *g) {
+    entries.clear();
+    cells.clear();
+    large.clear();
+    // cells about twice the average size of children give short lists per cell
+    long long sum = 0;
+    for (int i = 0; i < g->children(); i++)
+      sum += std::max(g->child(i)->w(), g->child(i)->h());
+    cell = g->children() ? int(2 * sum / g->children()) : 64;
+    cell = std::min(std::max(cell, 16), 4096);
+    dx = dy = 0;
+    bx = by = 0; br = bb = -1;
+    next_order = 0;
+    order_valid = true;
+    for (int i = 0; i < g->children(); i++)
+      add(g->child(i), next_order++);
+    built = entries.size();
+  }
+
+  void add(Fl_Widget *o, int order) {
+    Entry e = { o->x() - dx, o->y() - dy, o->w(), o->h(), 0, 0, 0, 0, order };
+    e.c0 = div(e.x, cell); e.c1 = div(e.x + std::max(e.w, 1) - 1, cell);
+    e.r0 = div(e.y, cell); e.r1 = div(e.y + std::max(e.h, 1) - 1, cell);
+    bool outside_label = (o->align() & 15) && !(o->align() & FL_ALIGN_INSIDE);
+    if (outside_label || (long long)(e.c1 - e.c0 + 1) * (e.r1 - e.r0 + 1) > 16) {
+      e.c0 = 1; e.c1 = 0;
+      large.push_back(o);
+    } else {
+      for (int r = e.r0; r <= e.r1; r++)
+        for (int c = e.c0; c <= e.c1; c++)
+          cells[key(c, r)].push_back(o);
+    }
+    if (br < bx) { bx = e.x; by = e.y; br = e.x + e.w; bb = e.y + e.h; }
+    else {
+      bx = std::min(bx, e.x); by = std::min(by, e.y);
+      br = std::max(br, e.x + e.w); bb = std::max(bb, e.y + e.h);
+    }
+    entries[o] = e;
+  }
+
+  static void erase(std::vector<Fl_Widget*> &list, const Fl_Widget *o) {
+    std::vector<Fl_Widget*>::iterator it = std::find(list.begin(), list.end(), o);
+    if (it != list.end()) {
+      *it = list.back();
+      list.pop_back();
+    }
+  }
+
+  // removes o, returns its order or -1
+  int remove(const Fl_Widget *o) {
+    std::unordered_map<const Fl_Widget*, Entry>::iterator it = entries.find(o);
+    if (it == entries.end()) return -1;
+    const Entry &e = it->second;
+    if (e.c0 > e.c1) erase(large, o);
+    for (int r = e.r0; r <= e.r1; r++) {
+      for (int c = e.c0; c <= e.c1; c++) {
+        std::unordered_map<long long, std::vector<Fl_Widget*> >::iterator l = cells.find(key(c, r));
+        if (l == cells.end()) continue;
+        erase(l->second, o);
+        if (l->second.empty()) cells.erase(l);
+      }
+    }
+    int order = e.order;
+    entries.erase(it);
+    return order;
+  }
+
+  void moved(Fl_Widget *o) {
+    int order = remove(o);
+    if (order >= 0) add(o, order);
+  }
+
+  // appends the children that overlap X,Y,W,H to list in the order of the children
+  void find(const Fl_Group *g, int X, int Y, int W, int H, std::vector<Fl_Widget*> &list) {
+    if (!order_valid) {
+      for (int i = 0; i < g->children(); i++) entries[g->child(i)].order = i;
+      next_order = g->children();
+      order_valid = true;
+    }
+    X -= dx; Y -= dy;
+    std::vector<std::pair<int, Fl_Widget*> > found;
+    for (size_t i = 0; i < large.size(); i++)
+      found.push_back(std::make_pair(entries[large[i]].order, large[i]));
+    if (W > 0 && H > 0) {
+      int c0 = div(X, cell), c1 = div(X + W - 1, cell);
+      int r0 = div(Y, cell), r1 = div(Y + H - 1, cell);
+      if ((long long)(c1 - c0 + 1) * (r1 - r0 + 1) > (long long)cells.size()) {
+        // fewer cells are used than the rectangle covers
+        std::unordered_map<long long, std::vector<Fl_Widget*> >::iterator it;
+        for (it = cells.begin(); it != cells.end(); ++it)
+          add_overlapping(it->second, X, Y, W, H, found);
+      } else {
+        for (int r = r0; r <= r1; r++) {
+          for (int c = c0; c <= c1; c++) {
+            std::unordered_map<long long, std::vector<Fl_Widget*> >::iterator it = cells.find(key(c, r));
+            if (it != cells.end()) add_overlapping(it->second, X, Y, W, H, found);
+          }
+        }
+      }
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    for (size_t i = 0; i < found.size(); i++)
+      list.push_back(found[i].second);
+  }
+
+  void add_overlapping(const std::vector<Fl_Widget*> &l, int X, int Y, int W, int H,
+                       std::vector<std::pair<int, Fl_Widget*> > &found) {
+    for (size_t i = 0; i < l.size(); i++) {
+      const Entry &e = entries[l[i]];
+      if (e.x < X + W && e.x + e.w > X && e.y < Y + H && e.y + e.h > Y)
+        found.push_back(std::make_pair(e.order, l[i]));
+    }
+  }
+};
+
 /**
   Returns a pointer to the internal array of children.
 
@@ -150,6 +293,21 @@ int Fl_Group::handle(int event) {
   Fl_Widget*const* a = array();
   int i;
   Fl_Widget* o;
+  // the children that may be at the event position, all children
+  // unless the group has a spatial index
+  Fl_Widget*const* at = a;
+  int n = children();
+  std::vector<Fl_Widget*> list;
+  if (spatial_index_) {
+    switch (event) {
+      case FL_SHORTCUT: case FL_ENTER: case FL_MOVE: case FL_DND_ENTER: case FL_DND_DRAG:
+      case FL_PUSH: case FL_RELEASE: case FL_DRAG: case FL_MOUSEWHEEL:
+        children_in(Fl::event_x(), Fl::event_y(), 1, 1, at, n, list);
+        break;
+      default:
+        break;
+    }
+  }
 
   switch (event) {
 
@@ -176,8 +334,8 @@ int Fl_Group::handle(int event) {
     return navigation(navkey());
 
   case FL_SHORTCUT:
-    for (i = children(); i--;) {
-      o = a[i];
+    for (i = n; i--;) {
+      o = at[i];
       if (o->takesevents() && Fl::event_inside(o) && send(o,FL_SHORTCUT))
         return 1;
     }
@@ -191,8 +349,8 @@ int Fl_Group::handle(int event) {
 
   case FL_ENTER:
   case FL_MOVE:
-    for (i = children(); i--;) {
-      o = a[i];
+    for (i = n; i--;) {
+      o = at[i];
       if (o->visible() && Fl::event_inside(o)) {
         if (o->contains(Fl::belowmouse())) {
           return send(o,FL_MOVE);
@@ -207,8 +365,8 @@ int Fl_Group::handle(int event) {
 
   case FL_DND_ENTER:
   case FL_DND_DRAG:
-    for (i = children(); i--;) {
-      o = a[i];
+    for (i = n; i--;) {
+      o = at[i];
       if (o->takesevents() && Fl::event_inside(o)) {
         if (o->contains(Fl::belowmouse())) {
           return send(o,FL_DND_DRAG);
@@ -222,8 +380,8 @@ int Fl_Group::handle(int event) {
     return 0;
 
   case FL_PUSH:
-    for (i = children(); i--;) {
-      o = a[i];
+    for (i = n; i--;) {
+      o = at[i];
       if (o->takesevents() && Fl::event_inside(o)) {
         Fl_Widget_Tracker wp(o);
         if (send(o,FL_PUSH)) {
@@ -240,8 +398,8 @@ int Fl_Group::handle(int event) {
     if (o == this) return 0;
     else if (o) send(o,event);
     else {
-      for (i = children(); i--;) {
-        o = a[i];
+      for (i = n; i--;) {
+        o = at[i];
         if (o->takesevents() && Fl::event_inside(o)) {
           if (send(o,event)) return 1;
         }
@@ -250,8 +408,8 @@ int Fl_Group::handle(int event) {
     return 0;
 
   case FL_MOUSEWHEEL:
-    for (i = children(); i--;) {
-      o = a[i];
+    for (i = n; i--;) {
+      o = at[i];
       if (o->takesevents() && Fl::event_inside(o) && send(o,FL_MOUSEWHEEL))
         return 1;
     }
@@ -358,6 +516,7 @@ Fl_Group::Fl_Group(int X, int Y, int W, int H, const char *L)
   resizable_ = this;
   bounds_ = 0; // this is allocated when first resize() is done
   sizes_ = 0;  // see bounds_ (FLTK 1.3 compatibility)
+  spatial_index_ = 0;
 
   // Subclasses may want to construct child objects as part of their
   // constructor, so make sure they are add()'d to this object.
@@ -437,6 +596,7 @@ Fl_Group::~Fl_Group() {
   if (current_ == this)
     end();
   clear();
+  delete spatial_index_;
 }
 
 /**
@@ -521,6 +681,7 @@ void Fl_Group::insert(Fl_Widget &o, int index) {
           child_[j] = child_[j - 1];
       }
       child_[index] = &o;
+      if (spatial_index_) spatial_index_->order_valid = false;
       init_sizes();
       return;
     }
@@ -535,6 +696,14 @@ void Fl_Group::insert(Fl_Widget &o, int index) {
     child_.insert(child_.begin() + index, &o);
   }
   o.parent_ = this;
+  if (spatial_index_) {
+    if (spatial_index_->entries.size() >= 2 * spatial_index_->built + 64) {
+      spatial_index_->build(this); // choose the cell size again
+    } else {
+      spatial_index_->add(&o, spatial_index_->next_order++);
+      if (&o != child_.back()) spatial_index_->order_valid = false;
+    }
+  }
   init_sizes();
 }
 
@@ -582,6 +751,7 @@ void Fl_Group::remove(int index) {
   if (o.parent_ == this) {      // this should always be true
     o.parent_ = 0;
   }
+  if (spatial_index_) spatial_index_->remove(&o);
 
   if (index == children() - 1) {
     child_.pop_back();
@@ -831,13 +1001,8 @@ void Fl_Group::resize(int X, int Y, int W, int H) {
     // Note that subwindows require resize() even if their relative position
     // didn't change, at least on macOS, if it's a rescale.
 
-    if (Fl_Window::is_a_rescale() || dx || dy) {
-      Fl_Widget*const* a = array();
-      for (int i = children(); i--;) {
-        Fl_Widget* o = *a++;
-        o->resize(o->x() + dx, o->y() + dy, o->w(), o->h());
-      }
-    }
+    if (Fl_Window::is_a_rescale() || dx || dy)
+      move_children(dx, dy, children());
   } // End of part 1
 
   // Part 2: here we definitely have a resizable() widget, resize children
@@ -894,6 +1059,104 @@ void Fl_Group::resize(int X, int Y, int W, int H) {
   } // End of part 2: we have a resizable() widget
 }
 
+/**
+  Moves the first \p n children by \p dx, \p dy.
+
+  This calls resize() of each child. If the group has a spatial index, the
+  index is moved as a whole, rather than updated for each child.
+
+  \param[in] dx, dy  distance to move the children
+  \param[in] n       number of children to move, starting with the first one
+  \see spatial_index(int)
+  \since 1.5.0
+*/
+void Fl_Group::move_children(int dx, int dy, int n) {
+  Spatial_Index *si = spatial_index_;
+  spatial_index_ = 0; // don't update the index for each child
+  Fl_Widget*const* a = array();
+  for (int i = n; i--;) {
+    Fl_Widget* o = *a++;
+    o->resize(o->x() + dx, o->y() + dy, o->w(), o->h());
+  }
+  spatial_index_ = si;
+  if (si) {
+    si->dx += dx;
+    si->dy += dy;
+    for (int i = n; i < children(); i++) // children that were not moved
+      si->moved(child(i));
+  }
+}
+
+/**
+  Finds the children that overlap a rectangle, using the spatial index.
+
+  Without spatial index this does nothing, and \p a and \p n keep
+  describing all children. Otherwise \p list is filled with the children
+  whose bounding boxes overlap \p X, \p Y, \p W, \p H, in the order of
+  the children, and \p a and \p n are set to describe \p list. Children
+  with labels outside of their bounding boxes are always included.
+
+  \param[in] X, Y, W, H  the rectangle
+  \param[in,out] a       array of children, initially array()
+  \param[in,out] n       number of children in \p a, initially children()
+  \param[out] list       storage for the children that are found
+  \see spatial_index(int)
+  \since 1.5.0
+*/
+void Fl_Group::children_in(int X, int Y, int W, int H, Fl_Widget*const* &a, int &n,
+                           std::vector<Fl_Widget*> &list) const {
+  if (!spatial_index_) return;
+  spatial_index_->find(this, X, Y, W, H, list);
+  a = list.empty() ? 0 : &list[0];
+  n = (int)list.size();
+}
+
+// called by Fl_Widget::resize() of children if the group has a spatial index
+void Fl_Group::child_resized_(Fl_Widget *o) {
+  spatial_index_->moved(o);
+}
+
+/**
+  Enables or disables a spatial index of the children.
+
+  Without the index, the group checks all children to find the ones under
+  the mouse for mouse events, and draws all children when it is redrawn,
+  which is slow for groups with many thousands of children, e.g. an
+  Fl_Scroll that is used as a canvas with many small widgets.
+
+  The index divides the area of the children in a grid of cells and
+  remembers the children that overlap each cell. It is updated when
+  children are added, removed, or moved and resized with resize(). The
+  size of the cells is chosen from the average size of the children when
+  the index is built, so it is best enabled after the children were added.
+
+  If children are moved by other means, or the alignment of their labels
+  is changed to or from outside of the widget, call spatial_index(1) again
+  to rebuild the index.
+
+  \param[in] onoff 1 to enable, 0 to disable the index
+  \see spatial_index() const
+  \since 1.5.0
+*/
+void Fl_Group::spatial_index(int onoff) {
+  if (onoff) {
+    if (!spatial_index_) spatial_index_ = new Spatial_Index;
+    spatial_index_->build(this);
+  } else {
+    delete spatial_index_;
+    spatial_index_ = 0;
+  }
+}
+
+/**
+  Returns 1 if the spatial index is enabled.
+  \see spatial_index(int)
+  \since 1.5.0
+*/
+int Fl_Group::spatial_index() const {
+  return spatial_index_ ? 1 : 0;
+}
+
 /**
   Draws all children of the group.
 
@@ -912,7 +1175,15 @@ void Fl_Group::draw_children() {
   }
 
   if (damage() & ~FL_DAMAGE_CHILD) { // redraw the entire thing:
-    for (int i = children(); i--;) {
+    int n = children();
+    std::vector<Fl_Widget*> list;
+    if (spatial_index_ && n) { // draw only the children in the clip region
+      const Spatial_Index *si = spatial_index_;
+      int X, Y, W, H;
+      if (fl_clip_box(si->bx + si->dx, si->by + si->dy, si->br - si->bx, si->bb - si->by, X, Y, W, H))
+        children_in(X, Y, W, H, a, n, list);
+    }
+    for (int i = n; i--;) {
       Fl_Widget& o = **a++;
       draw_child(o);
       draw_outside_label(o);
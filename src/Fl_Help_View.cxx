@@ -44,7 +44,9 @@
 #include <ctype.h>
 #include <errno.h>
 #include <math.h>
+#include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -108,9 +110,18 @@ public:
     selection_last_ = 0;
 
     scrollbar_size_ = 0;
+
+    width_driver_ = nullptr;
+    width_scale_  = 0.0f;
+    format_width_ = -1;
+    format_time_  = 0.0;
+    reflow_pending_ = false;
+    async_images_ = false;
   }
   ~Impl()
   {
+    if (reflow_pending_)
+      Fl::remove_timeout(reflow_cb, this);
     clear_selection();
     free_data();
   }
@@ -138,7 +149,6 @@ public:
   public:
     void add(int ucs);
     int cmp(const char *str);
-    int width() const;
   };
 
   /** Private struct to describe blocks of text. */
@@ -185,6 +195,14 @@ public:
     std::vector<Font_Style> elts_;    ///< font elements
   };
 
+  /** Private struct for an image requested with Fl_Shared_Image::get_async(). */
+  struct Image_Request {
+    Impl          *impl;                // Widget that requested the image
+    int           id;                   // Request id, 0 when done, -1 during get_async()
+    int           w, h;                 // Requested size, 0 if not given in the document
+    Fl_Shared_Image *image;             // Loaded image, nullptr if it can't be loaded
+  };
+
   enum class Align { RIGHT = -1, CENTER, LEFT };  ///< Alignments
   enum class Mode { DRAW, PUSH, DRAG };           ///< Draw modes
 
@@ -203,6 +221,9 @@ public:
   std::vector<Text_Block> blocks_;      ///< List of all text blocks on screen
   std::vector<std::shared_ptr<Link> > link_list_; ///< List of all clickable links and their position on screen
   std::map<std::string, int> target_line_map_;    ///< List of vertical position of all HTML Targets in a document
+  std::vector<Fl_Shared_Image*> images_;          ///< References to all images loaded by `get_image()`
+  std::map<std::string, Image_Request> image_requests_; ///< Images loaded in the background, by URL and size
+  bool          async_images_;          ///< Load images in the background, see `async_images()`
 
   int           topline_;               ///< Vertical offset of document, measure in pixels
   int           leftline_;              ///< Horizontal offset of document, measure in pixels
@@ -242,6 +263,22 @@ public:
 
   int           scrollbar_size_;        ///< Size for both scrollbars
 
+  // Layout cache
+
+  std::unordered_map<std::string, int> widths_; ///< Widths of words in all fonts used by the document, see text_width()
+  std::string   width_key_;             ///< Lookup key for `widths_`, font and size followed by the text
+  Fl_Graphics_Driver *width_driver_;    ///< Graphics driver that measured the text in `widths_`
+  float         width_scale_;           ///< Scale factor of the driver that measured the text in `widths_`
+  int           format_width_;          ///< Width of the widget area used by the last `format()`, -1 if none
+  double        format_time_;           ///< Seconds used by the last `format()`
+  bool          reflow_pending_;        ///< True while `reflow_cb()` is scheduled by `resize()`
+
+  // Search index, see build_search_text()
+
+  std::string   search_text_;           ///< Text of all blocks in lower case, without HTML tags and entities
+  std::vector<int> search_offsets_;     ///< Offset in value_ of each byte of `search_text_`
+  std::vector<size_t> search_blocks_;   ///< Start of each block in `search_text_`, empty if not built yet
+
   private: // methods
 
   // HTML source and raw data, getter
@@ -258,6 +295,16 @@ public:
   int           do_align(Text_Block *block, int line, int xx, Align a, int &l);
   void          format();
   void          format_table(int *table_width, int *columns, const char *table);
+  void          update_scrollbars();
+  int           layout_width() const;
+  void          flush_reflow();
+  void          reflow_later(double delay);
+  static void   reflow_cb(void *v);
+  static void   image_cb(Fl_Shared_Image *img, void *data);
+  void          build_search_text();
+  int           text_width(const std::string &s);
+  /// Width of a space in the current font.
+  int           space_width() { return text_width(" "); }
   Align         get_align(const char *p, Align a);
   const char    *get_attr(const char *p, const char *n, char *buf, int bufsize);
   Fl_Color      get_color(const char *n, Fl_Color c);
@@ -305,7 +352,12 @@ public:
   const char    *value() const { return (value_); }
   int           load(const char *f);
   int           find(const char *s, int p = 0);
+  std::vector<int> find_all(const char *s);
   void          link(Fl_Help_Func *fn);
+  /** Load images in the background. */
+  void          async_images(int onoff) { async_images_ = (onoff != 0); }
+  /** Return whether images are loaded in the background. */
+  int           async_images() const { return async_images_; }
 
   const char    *filename() const;
   const char    *directory() const;
@@ -372,6 +424,11 @@ static int quote_char(const char *);
 static std::string to_lower(const std::string &str);
 static size_t url_scheme(const std::string &url, bool skip_slashes=false);
 static const char *vanilla(const char *p, const char *end);
+static void fold_text(unsigned c, std::string &out);
+static void fold_text(const char *s, const char *end, std::string &out);
+static void search_skip(const std::string &pat, size_t skip[256]);
+static size_t search_folded(const std::string &text, size_t from, size_t to,
+                            const std::string &pat, const size_t skip[256]);
 static uint32_t command(const char *cmd);
 
 static constexpr uint32_t CMD(char a, char b, char c, char d)
@@ -477,11 +534,6 @@ int Fl_Help_View::Impl::Edit_Buffer::cmp(const char *str) {
   return !strcasecmp(c_str(), str);
 }
 
-// string width of the entire buffer contents
-int Fl_Help_View::Impl::Edit_Buffer::width() const {
-  return (int)fl_width(c_str());
-}
-
 
 // ---- Implementation of Font_Style class methods
 
@@ -597,72 +649,21 @@ size_t Fl_Help_View::Impl::Font_Stack::count() const {
   \brief Frees memory used for the document.
   */
 void Fl_Help_View::Impl::free_data() {
-  // Release all images...
-  if (value_) {
-    const char  *ptr,           // Pointer into block
-                *attrs;         // Pointer to start of element attributes
-    Edit_Buffer buf;            // Text buffer
-    char        attr[1024],     // Attribute buffer
-                wattr[1024],    // Width attribute buffer
-                hattr[1024];    // Height attribute buffer
-
-    DEBUG_FUNCTION(__LINE__,__FUNCTION__);
-
-    for (ptr = value_; *ptr;)
-    {
-      if (*ptr == '<')
-      {
-        ptr ++;
-
-        if (strncmp(ptr, "!--", 3) == 0)
-        {
-          // Comment...
-          ptr += 3;
-          if ((ptr = strstr(ptr, "-->")) != nullptr)
-          {
-            ptr += 3;
-            continue;
-          }
-          else
-            break;
-        }
-
-        buf.clear();
-
-        while (*ptr && *ptr != '>' && !isspace((*ptr)&255))
-          buf += *ptr++;
-
-        attrs = ptr;
-        while (*ptr && *ptr != '>')
-          ptr ++;
-
-        if (*ptr == '>')
-          ptr ++;
-
-        if (buf.cmp("IMG"))
-        {
-          Fl_Shared_Image       *img;
-          int           width;
-          int           height;
-
-          get_attr(attrs, "WIDTH", wattr, sizeof(wattr));
-          get_attr(attrs, "HEIGHT", hattr, sizeof(hattr));
-          width  = get_length(wattr);
-          height = get_length(hattr);
+  DEBUG_FUNCTION(__LINE__,__FUNCTION__);
 
-          if (get_attr(attrs, "SRC", attr, sizeof(attr))) {
-            // Get and release the image to free it from memory...
-            img = get_image(attr, width, height);
-            if ((void*)img != &broken_image) {
-              img->release();
-            }
-          }
-        }
-      }
-      else
-        ptr++;
-    }
+  // Release all images...
+  for (Fl_Shared_Image *img : images_)
+    img->release();
+  images_.clear();
+  for (auto &r : image_requests_) {
+    if (r.second.id > 0)
+      Fl_Shared_Image::cancel_async(r.second.id);
+    if (r.second.image)
+      r.second.image->release();
+  }
+  image_requests_.clear();
 
+  if (value_) {
     free((void *)value_);
     value_ = 0;
   }
@@ -872,6 +873,80 @@ int Fl_Help_View::Impl::do_align(
 }
 
 
+/**
+  \brief Returns the width of a string in the current font.
+
+  The widths are cached per font and size, so that every word of the
+  document is measured only once, and not again every time the document
+  is formatted for a new widget width. The cache is cleared when the text
+  is measured by another graphics driver or at another scale.
+
+  \param[in] s text to measure
+  \return width in pixels
+  */
+int Fl_Help_View::Impl::text_width(const std::string &s) {
+  if (fl_graphics_driver != width_driver_ || fl_graphics_driver->scale() != width_scale_ ||
+      widths_.size() > 100000) {
+    widths_.clear();
+    width_driver_ = fl_graphics_driver;
+    width_scale_ = fl_graphics_driver->scale();
+  }
+  Fl_Font f = fl_font();
+  Fl_Fontsize fs = fl_size();
+  width_key_.assign((const char *)&f, sizeof(f));
+  width_key_.append((const char *)&fs, sizeof(fs));
+  width_key_.append(s);
+  auto it = widths_.find(width_key_);
+  if (it != widths_.end())
+    return it->second;
+  int w = (int)fl_width(s.c_str());
+  widths_[width_key_] = w;
+  return w;
+}
+
+
+/**
+  \brief Returns the width available to the document without vertical scrollbar.
+  */
+int Fl_Help_View::Impl::layout_width() const {
+  Fl_Boxtype b = view.box() ? view.box() : FL_DOWN_BOX; // Box to draw...
+  int scrollsize = scrollbar_size_ ? scrollbar_size_ : Fl::scrollbar_size();
+  return view.w() - scrollsize - Fl::box_dw(b);
+}
+
+
+/**
+  \brief Formats the document now if resize() has delayed it.
+  */
+void Fl_Help_View::Impl::flush_reflow() {
+  if (reflow_pending_)
+    format();
+}
+
+
+/**
+  \brief Formats the document after a delay, unless this is already scheduled.
+  \param[in] delay time in seconds
+  */
+void Fl_Help_View::Impl::reflow_later(double delay) {
+  if (!reflow_pending_) {
+    reflow_pending_ = true;
+    Fl::add_timeout(delay, reflow_cb, this);
+  }
+}
+
+
+/**
+  \brief Timer callback for the formatting delayed by resize() or image_cb().
+  */
+void Fl_Help_View::Impl::reflow_cb(void *v) {
+  Impl *impl = (Impl *)v;
+  impl->reflow_pending_ = false;
+  impl->format();
+  impl->view.redraw();
+}
+
+
 /**
   \brief Formats the help text and lays out the HTML content for display.
 
@@ -917,8 +992,6 @@ void Fl_Help_View::Impl::format() {
                 columns[MAX_COLUMNS];
                                 // Column widths
   Fl_Color      tc, rc;         // Table/row background color
-  Fl_Boxtype    b = view.box() ? view.box() : FL_DOWN_BOX;
-                                // Box to draw...
   Margin_Stack  margins;        // Left margin stack...
   std::vector<int> OL_num;         // if nonnegative, in OL mode and this is the item number
 
@@ -926,9 +999,21 @@ void Fl_Help_View::Impl::format() {
 
   DEBUG_FUNCTION(__LINE__,__FUNCTION__);
 
+  // A pending reflow from resize() is done now...
+  if (reflow_pending_) {
+    Fl::remove_timeout(reflow_cb, this);
+    reflow_pending_ = false;
+  }
+  Fl_Timestamp start_time = Fl::now();
+
+  // The search index refers to the old blocks...
+  search_text_.clear();
+  search_offsets_.clear();
+  search_blocks_.clear();
+
   // Reset document width...
-  int scrollsize = scrollbar_size_ ? scrollbar_size_ : Fl::scrollbar_size();
-  hsize_ = view.w() - scrollsize - Fl::box_dw(b);
+  format_width_ = layout_width();
+  hsize_ = format_width_;
 
   done = 0;
   while (!done)
@@ -979,7 +1064,7 @@ void Fl_Help_View::Impl::format() {
       if ((*ptr == '<' || isspace((*ptr)&255)) && buf.size() > 0)
       {
         // Get width of word parsed so far...
-        ww = buf.width();
+        ww = text_width(buf);
 
         if (!head && !pre)
         {
@@ -991,7 +1076,7 @@ void Fl_Help_View::Impl::format() {
           }
 
           if (needspace && xx > block->x)
-            ww += (int)fl_width(' ');
+            ww += space_width();
 
   //        printf("line = %d, xx = %d, ww = %d, block->x = %d, block->w = %d\n",
   //           line, xx, ww, block->x, block->w);
@@ -1038,7 +1123,7 @@ void Fl_Help_View::Impl::format() {
               hh       = fsize + 2;
             }
             else
-              xx += (int)fl_width(' ');
+              xx += space_width();
 
             if ((fsize + 2) > hh)
               hh = fsize + 2;
@@ -1540,8 +1625,10 @@ void Fl_Help_View::Impl::format() {
 
           if (get_attr(attrs, "SRC", attr, sizeof(attr))) {
             img    = get_image(attr, width, height);
-            width  = img->w();
-            height = img->h();
+            if (img) {                  // else use the size in the document until it is loaded
+              width  = img->w();
+              height = img->h();
+            }
           }
 
           ww = width;
@@ -1553,7 +1640,7 @@ void Fl_Help_View::Impl::format() {
           }
 
           if (needspace && xx > block->x)
-            ww += (int)fl_width(' ');
+            ww += space_width();
 
           if ((xx + ww) > block->w)
           {
@@ -1597,7 +1684,7 @@ void Fl_Help_View::Impl::format() {
       {
         needspace = 1;
         if ( pre ) {
-          xx += (int)fl_width(' ');
+          xx += space_width();
         }
         ptr ++;
       }
@@ -1629,7 +1716,7 @@ void Fl_Help_View::Impl::format() {
 
     if (buf.size() > 0 && !head)
     {
-      ww = buf.width();
+      ww = text_width(buf);
 
   //    printf("line = %d, xx = %d, ww = %d, block->x = %d, block->w = %d\n",
   //       line, xx, ww, block->x, block->w);
@@ -1641,7 +1728,7 @@ void Fl_Help_View::Impl::format() {
       }
 
       if (needspace && xx > block->x)
-        ww += (int)fl_width(' ');
+        ww += space_width();
 
       if ((xx + ww) > block->w)
       {
@@ -1668,6 +1755,17 @@ void Fl_Help_View::Impl::format() {
 
 //  printf("margins.depth_=%d\n", margins.depth_);
 
+  format_time_ = Fl::seconds_since(start_time);
+  update_scrollbars();
+}
+
+
+/**
+  \brief Shows, hides, and positions the scrollbars for the formatted document.
+  Also clamps the top line and left position to the new document size.
+  */
+void Fl_Help_View::Impl::update_scrollbars() {
+  Fl_Boxtype b = view.box() ? view.box() : FL_DOWN_BOX; // Box to draw...
   int dx = Fl::box_dw(b) - Fl::box_dx(b);
   int dy = Fl::box_dh(b) - Fl::box_dy(b);
   int ss = scrollbar_size_ ? scrollbar_size_ : Fl::scrollbar_size();
@@ -1778,7 +1876,7 @@ void Fl_Help_View::Impl::format_table(
         needspace = 0;
       }
 
-      temp_width = buf.width();
+      temp_width = text_width(buf);
       buf.clear();
 
       if (temp_width > minwidths[column])
@@ -2004,8 +2102,10 @@ void Fl_Help_View::Impl::format_table(
 
         if (get_attr(attrs, "SRC", attr, sizeof(attr))) {
           img     = get_image(attr, iwidth, iheight);
-          iwidth  = img->w();
-          iheight = img->h();
+          if (img) {
+            iwidth  = img->w();
+            iheight = img->h();
+          }
         }
 
         if (iwidth > minwidths[column])
@@ -2013,7 +2113,7 @@ void Fl_Help_View::Impl::format_table(
 
         width += iwidth;
         if (needspace)
-          width += (int)fl_width(' ');
+          width += space_width();
 
         if (width > max_width)
           max_width = width;
@@ -2332,8 +2432,16 @@ Fl_Color Fl_Help_View::Impl::get_color(const char *n, Fl_Color c)
   Calling Fl_Shared_Image::find() instead of Fl_Shared_Image::get() avoids
   doing unnecessary i/o for "broken images" within each resize/redraw.
 
-  Each image must be released exactly once in the destructor or before
-  a new document is loaded: see free_data().
+  The references taken by Fl_Shared_Image::get() are kept in images_ and
+  released in the destructor or before a new document is loaded: see
+  free_data().
+
+  If async_images() is set, each image is requested only once per size
+  with Fl_Shared_Image::get_async(), independent of initial_load, and
+  get_image() returns nullptr until it is loaded. format() then uses the
+  WIDTH and HEIGHT attributes of the image. image_cb() keeps the reference
+  to the image in image_requests_ and redraws the widget, or formats the
+  document again if the image size was not given.
 */
 
 /**
@@ -2345,7 +2453,8 @@ Fl_Color Fl_Help_View::Impl::get_color(const char *n, Fl_Color c)
   \param[in] name the image name, either a local filename or a URL.
   \param[in] W, H the size of the image, or 0 if not specified.
   \return a pointer to a cached Fl_Shared_Image, if the image can be loaded,
-          otherwise a pointer to an internal Fl_Pixmap (broken_image).
+          otherwise a pointer to an internal Fl_Pixmap (broken_image),
+          or nullptr while the image is loaded in the background.
 
   \todo Fl_Help_View::Impl::get_image() returns a pointer to the internal
   Fl_Pixmap broken_image, but this is _not_ compatible with the
@@ -2403,9 +2512,30 @@ Fl_Shared_Image *Fl_Help_View::Impl::get_image(const char *name, int W, int H)
     url = url.substr(5);
   }
 
-  if (initial_load) {
+  if (async_images_) {
+    // Worker threads load the image, image_cb() updates the layout when done
+    std::string key = url + '\n' + std::to_string(W) + 'x' + std::to_string(H);
+    auto it = image_requests_.find(key);
+    if (it == image_requests_.end()) {
+      Image_Request &req = image_requests_[key];
+      req.impl = this;
+      req.id = -1;
+      req.w = W;
+      req.h = H;
+      req.image = nullptr;
+      int id = Fl_Shared_Image::get_async(url.c_str(), W, H, image_cb, &req);
+      if (req.id < 0) req.id = id;
+      it = image_requests_.find(key);
+    }
+    if (it->second.id)
+      return nullptr;   // not loaded yet
+    ip = it->second.image;
+    if (!ip) ip = (Fl_Shared_Image *)&broken_image;
+  } else if (initial_load) {
     if ((ip = Fl_Shared_Image::get(url.c_str(), W, H)) == nullptr) {
       ip = (Fl_Shared_Image *)&broken_image;
+    } else {
+      images_.push_back(ip);
     }
   } else { // draw or resize
     if ((ip = Fl_Shared_Image::find(url.c_str(), W, H)) == nullptr) {
@@ -2419,6 +2549,28 @@ Fl_Shared_Image *Fl_Help_View::Impl::get_image(const char *name, int W, int H)
 }
 
 
+/**
+  \brief Callback for images loaded by Fl_Shared_Image::get_async().
+  \param[in] img the loaded image, or nullptr if it can't be loaded
+  \param[in] data the Image_Request of the image
+  */
+void Fl_Help_View::Impl::image_cb(Fl_Shared_Image *img, void *data) {
+  Image_Request *req = (Image_Request *)data;
+  bool in_background = (req->id > 0); // else called by get_async() itself
+  req->id = 0;
+  req->image = img;
+  if (!in_background)
+    return;
+  if (img && req->w && req->h) {
+    // The document reserved the space already
+    req->impl->view.redraw();
+  } else {
+    // Format once for all images that are loaded at about the same time
+    req->impl->reflow_later(0.05);
+  }
+}
+
+
 /**
   \brief Gets a length value, either absolute or %.
   \param[in] l string containing the length value
@@ -2723,10 +2875,10 @@ void Fl_Help_View::Impl::draw()
           if (!head && !pre)
           {
             // Check width...
-            ww = buf.width();
+            ww = text_width(buf);
 
             if (needspace && xx > block->x)
-              xx += (int)fl_width(' ');
+              xx += space_width();
 
             if ((xx + ww) > block->w)
             {
@@ -2741,7 +2893,7 @@ void Fl_Help_View::Impl::draw()
             buf.clear();
             entity_extra_length = 0;
             if (underline) {
-              xtra_ww = isspace((*ptr)&255)?(int)fl_width(' '):0;
+              xtra_ww = isspace((*ptr)&255)?space_width():0;
               fl_xyline(xx + view.x() - leftline_, yy + view.y() + 1,
                         xx + view.x() - leftline_ + ww + xtra_ww);
             }
@@ -2761,7 +2913,7 @@ void Fl_Help_View::Impl::draw()
               {
                 hv_draw(buf.c_str(), xx + view.x() - leftline_, yy + view.y());
                 if (underline) fl_xyline(xx + view.x() - leftline_, yy + view.y() + 1,
-                                         xx + view.x() - leftline_ + buf.width());
+                                         xx + view.x() - leftline_ + text_width(buf));
                 buf.clear();
                 current_pos_ = (int) (ptr-value_);
                 if (line < 31)
@@ -2789,7 +2941,7 @@ void Fl_Help_View::Impl::draw()
             if (buf.size() > 0)
             {
               hv_draw(buf.c_str(), xx + view.x() - leftline_, yy + view.y());
-              ww = buf.width();
+              ww = text_width(buf);
               buf.clear();
               if (underline) fl_xyline(xx + view.x() - leftline_, yy + view.y() + 1,
                                        xx + view.x() - leftline_ + ww);
@@ -3045,8 +3197,8 @@ void Fl_Help_View::Impl::draw()
 
             if (get_attr(attrs, "SRC", attr, sizeof(attr))) {
               img = get_image(attr, width, height);
-              if (!width) width = img->w();
-              if (!height) height = img->h();
+              if (img && !width) width = img->w();
+              if (img && !height) height = img->h();
             }
 
             if (!width || !height) {
@@ -3058,7 +3210,7 @@ void Fl_Help_View::Impl::draw()
             ww = width;
 
             if (needspace && xx > block->x)
-              xx += (int)fl_width(' ');
+              xx += space_width();
 
             if ((xx + ww) > block->w)
             {
@@ -3148,10 +3300,10 @@ void Fl_Help_View::Impl::draw()
 
       if (buf.size() > 0 && !pre && !head)
       {
-        ww = buf.width();
+        ww = text_width(buf);
 
         if (needspace && xx > block->x)
-          xx += (int)fl_width(' ');
+          xx += space_width();
 
         if ((xx + ww) > block->w)
         {
@@ -3381,6 +3533,19 @@ void Fl_Help_View::Impl::resize(int xx, int yy, int ww, int hh)
   view.hscrollbar_.resize(view.x() + Fl::box_dx(b),
                      view.y() + view.h() - scrollsize - Fl::box_dh(b) + Fl::box_dy(b),
                      view.w() - scrollsize - Fl::box_dw(b), scrollsize);
+
+  // The layout depends only on the width, a new height only changes the scrollbars
+  if (layout_width() == format_width_ && !reflow_pending_) {
+    update_scrollbars();
+    return;
+  }
+
+  // Formatting a large document takes too long to be repeated for every step
+  // of an interactive resize, so it is done at most once per interval then
+  if (format_time_ > 0.02 && view.visible_r()) {
+    reflow_later(format_time_ > 0.05 ? 2 * format_time_ : 0.1);
+    return;
+  }
   format();
 }
 
@@ -3596,9 +3761,11 @@ int Fl_Help_View::Impl::load(const char *f)
   - the specified string \p s must be in UTF-8 encoding
   - HTML tags in value() are filtered (not compared as such, they never match)
   - HTML entities like '\&lt;' or '\&x#20ac;' are converted to Unicode (UTF-8)
-  - ASCII characters (7-bit, \< 0x80) are compared case insensitive
+  - all characters are compared case insensitive, see fl_tolower()
   - every newline (LF, '\\n') in value() is treated like a single space
-  - all other strings are compared as-is (byte by byte)
+
+  The text of the formatted document is prepared for searching only once,
+  so repeated calls to find the next match are fast.
 
   \param[in] s search string in UTF-8 encoding
   \param[in] p starting position for search (0,...), Default = 0
@@ -3608,19 +3775,28 @@ int Fl_Help_View::find(const char *s, int p) {
   return impl_->find(s, p);
 }
 
+/**
+  \brief Finds all occurrences of the string \p s.
+
+  The strings are compared like in find(const char *s, int p), but the document
+  is not scrolled. Occurrences do not overlap. This can be used to highlight
+  all matches, or to show how many there are.
+
+  \param[in] s search string in UTF-8 encoding
+  \return the sorted offsets in value() of all matches, empty if none
+  \see find(const char *s, int p)
+  \since 1.5.0
+*/
+std::vector<int> Fl_Help_View::find_all(const char *s) {
+  return impl_->find_all(s);
+}
+
 /**
   \brief Finds the specified string \p s at starting position \p p.
   \see Fl_Help_View::find(const char *s, int p)
  */
 int Fl_Help_View::Impl::find(const char *s, int p)
 {
-  int           i,                              // Looping var
-                c;                              // Current character
-  Text_Block *b;                             // Current block
-  const char    *bp,                            // Block matching pointer
-                *bs,                            // Start of current comparison
-                *sp;                            // Search string pointer
-
   DEBUG_FUNCTION(__LINE__,__FUNCTION__);
 
   // Range check input and value...
@@ -3628,82 +3804,106 @@ int Fl_Help_View::Impl::find(const char *s, int p)
 
   if (p < 0 || p >= (int)strlen(value_)) p = 0;
 
+  flush_reflow();
+  build_search_text();
+
+  std::string pattern;
+  fold_text(s, s + strlen(s), pattern);
+  size_t skip[256];
+  search_skip(pattern, skip);
+
   // Look for the string...
-  for (i = (int)blocks_.size(), b = &blocks_[0]; i > 0; i--, b++) {
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    Text_Block *b = &blocks_[i];
     if (b->end < (value_ + p))
       continue;
 
-    if (b->start < (value_ + p))
-      bp = value_ + p;
-    else
-      bp = b->start;
+    size_t first = search_blocks_[i], last = search_blocks_[i + 1];
+    first = std::lower_bound(search_offsets_.begin() + first, search_offsets_.begin() + last, p)
+            - search_offsets_.begin();
+    size_t pos = search_folded(search_text_, first, last, pattern, skip);
+    if (pos != std::string::npos) { // Found a match!
+      topline(b->y - b->h);
+      return search_offsets_[pos];
+    }
+  }
+
+  // No match!
+  return (-1);
+}
+
+
+/**
+  \brief Finds all occurrences of the string \p s.
+  \see Fl_Help_View::find_all(const char *s)
+ */
+std::vector<int> Fl_Help_View::Impl::find_all(const char *s)
+{
+  std::vector<int> found;
+  if (!s || !*s || !value_) return found;
+
+  flush_reflow();
+  build_search_text();
+
+  std::string pattern;
+  fold_text(s, s + strlen(s), pattern);
+  size_t skip[256];
+  search_skip(pattern, skip);
+
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    size_t pos = search_blocks_[i], last = search_blocks_[i + 1];
+    while ((pos = search_folded(search_text_, pos, last, pattern, skip)) != std::string::npos) {
+      found.push_back(search_offsets_[pos]);
+      pos += pattern.size();
+    }
+  }
+
+  // Blocks of tables may overlap in value()
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  return found;
+}
 
-    bp = vanilla(bp, b->end);
-    if (bp == b->end)
-      continue;
 
-    for (sp = s, bs = bp; *sp && *bp && bp < b->end; ) {
-      bool is_html_entity = false;
+/**
+  \brief Builds the text that find() and find_all() search, once per format().
+
+  The text of each block in `blocks_` is copied to `search_text_` without
+  HTML tags, with HTML entities decoded, and in lower case, see fold_text().
+  `search_offsets_` holds the offset in value_ of each byte of the text, and
+  `search_blocks_` the start of each block in the text.
+  */
+void Fl_Help_View::Impl::build_search_text()
+{
+  if (!search_blocks_.empty())
+    return;
+
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    search_blocks_.push_back(search_text_.size());
+    const Text_Block &b = blocks_[i];
+    for (const char *bp = vanilla(b.start, b.end); bp < b.end; bp = vanilla(bp, b.end)) {
+      const char *next = bp + 1;
+      int c;
       if (*bp == '&') {
         // decode HTML entity...
-        if ((c = quote_char(bp + 1)) < 0) {
-          c = '&';
+        const char *entity_end = strchr(bp + 1, ';');
+        if (entity_end && (c = quote_char(bp + 1)) >= 0) {
+          fold_text(c, search_text_);
+          next = entity_end + 1;
         } else {
-          const char *entity_end = strchr(bp + 1, ';');
-          if (entity_end) {
-            is_html_entity = true; // c contains the unicode character
-            bp = entity_end;
-          } else {
-            c = '&';
-          }
+          fold_text(bp, next, search_text_);
         }
       } else {
-        c = *bp;
+        int len = 1;
+        if (*bp & 0x80)
+          fl_utf8decode(bp, b.end, &len);
+        next = bp + len;
+        fold_text(bp, next, search_text_);
       }
-
-      if (c == '\n') c = ' '; // treat newline as a single space
-
-      // *FIXME* *UTF-8* (A.S. 02/14/2016)
-      // At this point c may be an arbitrary Unicode Code Point corresponding
-      // to a quoted character (see above), i.e. it _can_ be a multi byte
-      // UTF-8 sequence and must be compared with the corresponding
-      // multi byte string in (*sp)...
-      // For instance: "&euro;" == 0x20ac -> 0xe2 0x82 0xac (UTF-8: 3 bytes).
-      // Hint: use fl_utf8encode() [see below]
-
-      int utf_len = 1;
-      if (c > 0x20 && c < 0x80 && tolower(*sp) == tolower(c)) {
-        // Check for ASCII case insensitive match.
-        //printf("%ld text match %c/%c\n", bp-value_, *sp, c);
-        sp++;
-        bp = vanilla(bp+1, b->end);
-      } else if (is_html_entity && fl_utf8decode(sp, nullptr, &utf_len) == (unsigned int)c ) {
-        // Check if a &lt; entity ini html matches a UTF-8 character in the
-        // search string.
-        //printf("%ld unicode match 0x%02X 0x%02X\n", bp-value_, *sp, c);
-        sp += utf_len;
-        bp = vanilla(bp+1, b->end);
-      } else if (*sp == c) {
-        // Check if UTF-8 bytes in html and the search string match.
-        //printf("%ld binary match %c/%c\n", bp-value_, *sp, c);
-        sp++;
-        bp = vanilla(bp+1, b->end);
-      } else {
-        // No match, so reset to start of search... .
-        //printf("reset search (%c/%c)\n", *sp, c);
-        sp = s;
-        bp = bs = vanilla(bs+1, b->end);
-      }
-    }
-
-    if (!*sp) { // Found a match!
-      topline(b->y - b->h);
-      return int(bs - value_);
+      search_offsets_.resize(search_text_.size(), int(bp - value_));
     }
   }
-
-  // No match!
-  return (-1);
+  search_blocks_.push_back(search_text_.size());
 }
 
 
@@ -3747,6 +3947,44 @@ void Fl_Help_View::Impl::link(Fl_Help_Func *fn)
 }
 
 
+/**
+  \brief Sets whether images are loaded in the background.
+
+  By default, value() and load() return when all images of the document
+  are loaded. If this is set, the images are loaded by the worker threads
+  of Fl_Shared_Image::get_async(), which limits the number of images that
+  are decoded at the same time. The document is shown at once, with empty
+  space for each image that is not loaded yet. Images that have WIDTH and
+  HEIGHT attributes get the right space immediately, for all other images
+  the document is formatted again when they are loaded.
+
+  This must be set before value() or load() is called.
+
+  \note As for any program that uses threads with FLTK, the program must
+    call Fl::lock() once before the first document is loaded.
+
+  \note Animated GIF images are shown without animation when they are
+    loaded in the background, see Fl_Shared_Image::get_async().
+
+  \param[in] onoff 1 to load images in the background, 0 to load them
+    in value() and load()
+  \see Fl_Shared_Image::get_async()
+  \since 1.5.0
+*/
+void Fl_Help_View::async_images(int onoff) {
+  impl_->async_images(onoff);
+}
+
+/**
+  \brief Returns whether images are loaded in the background.
+  \see async_images(int)
+  \since 1.5.0
+*/
+int Fl_Help_View::async_images() const {
+  return impl_->async_images();
+}
+
+
 /**
   \brief Return the current filename for the text in the buffer.
 
@@ -3833,6 +4071,7 @@ void Fl_Help_View::topline(const char *anchor) {
  */
 void Fl_Help_View::Impl::topline(const char *anchor)
 {
+  flush_reflow();
   std::string target_name = to_lower(anchor); // Convert to lower case
   auto tl = target_line_map_.find(target_name);
   if (tl != target_line_map_.end()) {
@@ -4168,6 +4407,74 @@ static const char *vanilla(const char *p, const char *end) {
 }
 
 
+/**
+  \brief Appends a character in lower case and UTF-8 encoding to a string.
+  A newline is appended as a space.
+  \param[in] c Unicode character
+  \param[in,out] out string to append to
+*/
+static void fold_text(unsigned c, std::string &out) {
+  if (c == '\n')
+    c = ' ';
+  if (c < 0x80) {
+    out += (char)tolower(c);
+  } else {
+    char buf[8];
+    out.append(buf, fl_utf8encode(fl_tolower(c), buf));
+  }
+}
+
+/**
+  \brief Appends text in lower case to a string, see fold_text(unsigned, std::string&).
+  \param[in] s, end UTF-8 text
+  \param[in,out] out string to append to
+*/
+static void fold_text(const char *s, const char *end, std::string &out) {
+  while (s < end) {
+    int len = 1;
+    unsigned c = (uchar)*s;
+    if (c & 0x80)
+      c = fl_utf8decode(s, end, &len);
+    fold_text(c, out);
+    s += len;
+  }
+}
+
+/**
+  \brief Fills the table of search_folded() for a search string.
+  \param[in] pat search string
+  \param[out] skip how far the search can advance for each last byte
+*/
+static void search_skip(const std::string &pat, size_t skip[256]) {
+  for (int i = 0; i < 256; i++)
+    skip[i] = pat.size();
+  for (size_t i = 0; i + 1 < pat.size(); i++)
+    skip[(uchar)pat[i]] = pat.size() - 1 - i;
+}
+
+/**
+  \brief Finds a string in a range of a text (Boyer-Moore-Horspool).
+  \param[in] text text to search
+  \param[in] from, to range of \p text to search
+  \param[in] pat search string
+  \param[in] skip table made by search_skip() for \p pat
+  \return position of the first match in \p text, or std::string::npos
+*/
+static size_t search_folded(const std::string &text, size_t from, size_t to,
+                            const std::string &pat, const size_t skip[256]) {
+  size_t n = pat.size();
+  if (n == 0)
+    return from < to ? from : std::string::npos;
+  const char *t = text.data();
+  while (from + n <= to) {
+    uchar last = (uchar)t[from + n - 1];
+    if (last == (uchar)pat[n - 1] && memcmp(t + from, pat.data(), n - 1) == 0)
+      return from;
+    from += skip[last];
+  }
+  return std::string::npos;
+}
+
 
 // convert a command with up to four letters into an unsigned int
 static uint32_t command(const char *cmd)
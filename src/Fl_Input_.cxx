@@ -18,6 +18,7 @@
 #include <FL/Fl_Input_.H>
 #include <FL/Fl_Window.H>
 #include "Fl_Screen_Driver.H"
+#include <FL/Fl_Graphics_Driver.H>
 #include <FL/fl_draw.H>
 #include <FL/fl_ask.H>
 #include <math.h>
@@ -26,6 +27,9 @@
 #include <stdlib.h>
 #include <ctype.h>
 
+#include <algorithm>
+#include <vector>
+
 #define MAXBUF 1024
 static int l_secret;
 
@@ -120,6 +124,126 @@ public:
   }
 };
 
+// Start and end of all lines as they are displayed, i.e. after word wrapping
+// and after splitting very long lines in expand(). drawtext(), handle_mouse(),
+// line_start() and line_end() use it instead of expanding all lines from the
+// start of the text, and replace() recomputes only the lines that changed.
+class Fl_Input_::Line_Table {
+public:
+  std::vector<int> start;   // index of the first byte of each line
+  std::vector<int> end;     // index after its last byte, before '\n' or the wrapping space
+  // the layout the lines were computed for:
+  int wrap_w, type, wrap;
+  Fl_Font font;
+  Fl_Fontsize size;
+  float scale;
+  Fl_Graphics_Driver *driver;
+
+  bool matches(const Fl_Input_ *in) const {
+    return wrap_w == wrap_width(in) && type == in->input_type() && wrap == in->wrap()
+           && font == in->textfont() && size == in->textsize()
+           && driver == fl_graphics_driver && scale == fl_graphics_driver->scale();
+  }
+  void layout(const Fl_Input_ *in) {
+    wrap_w = wrap_width(in); type = in->input_type(); wrap = in->wrap();
+    font = in->textfont(); size = in->textsize();
+    driver = fl_graphics_driver; scale = driver->scale();
+  }
+  // the width expand() wraps the text to
+  static int wrap_width(const Fl_Input_ *in) {
+    return in->w() - Fl::box_dw(in->box());
+  }
+  // index of the line that contains text index i, the upper one if i is
+  // both the end of a line and the start of the next line
+  int find(int i) const {
+    int n = int(std::lower_bound(end.begin(), end.end(), i) - end.begin());
+    return n < int(end.size()) ? n : int(end.size()) - 1;
+  }
+  void scan(const Fl_Input_ *in, int i, int sync, const std::vector<int> &old_start,
+            const std::vector<int> &old_end, int delta);
+};
+
+/*
+  Computes the lines from text index i to the end of the text. Once a line
+  starts at or after index sync, the remaining lines are copied from the
+  old lines shifted by delta if one of them starts at the same index,
+  because the lines only depend on the text after their start.
+*/
+void Fl_Input_::Line_Table::scan(const Fl_Input_ *in, int i, int sync,
+                                 const std::vector<int> &old_start,
+                                 const std::vector<int> &old_end, int delta) {
+  char buf[MAXBUF];
+  const char *v = in->value(), *p = v + i, *last = v + in->size();
+  size_t k = 0;
+  for (;;) {
+    const char *e = in->expand(p, buf);
+    start.push_back(int(p - v));
+    end.push_back(int(e - v));
+    if (e >= last) return;
+    if (*e == '\n' || *e == ' ') e++;
+    p = e;
+    i = int(p - v);
+    if (i < sync) continue;
+    while (k < old_start.size() && old_start[k] + delta < i) k++;
+    if (k < old_start.size() && old_start[k] + delta == i) {
+      for (; k < old_start.size(); k++) {
+        start.push_back(old_start[k] + delta);
+        end.push_back(old_end[k] + delta);
+      }
+      return;
+    }
+  }
+}
+
+/** \internal
+  Returns the table of displayed lines.
+
+  The table is valid as long as the text, the size, the font and the type
+  of the widget don't change.
+
+  \param [in] build if set, the table is computed if it is not valid
+  \return the table, or NULL if it is not valid and \p build is not set
+*/
+Fl_Input_::Line_Table* Fl_Input_::line_table(int build) const {
+  Line_Table *t = lines_;
+  if (t && !t->start.empty() && t->matches(this)) return t;
+  if (!build) return NULL;
+  if (!t) t = ((Fl_Input_*)this)->lines_ = new Line_Table;
+  t->start.clear();
+  t->end.clear();
+  t->layout(this);
+  setfont();
+  std::vector<int> none;
+  t->scan(this, 0, size() + 1, none, none, 0);
+  return t;
+}
+
+/** \internal
+  Updates the table of displayed lines after a change of the text.
+
+  \param [in] pos index of the change
+  \param [in] deleted number of bytes deleted at \p pos
+  \param [in] inserted number of bytes inserted at \p pos
+*/
+void Fl_Input_::lines_changed(int pos, int deleted, int inserted) {
+  Line_Table *t = lines_;
+  if (!t || t->start.empty()) return;
+  if (!t->matches(this)) {
+    t->start.clear();
+    t->end.clear();
+    return;
+  }
+  // word wrapping may move the first word of the changed line to the line above
+  int k = t->find(pos);
+  if (k > 0) k--;
+  std::vector<int> old_start(t->start.begin() + k + 1, t->start.end());
+  std::vector<int> old_end(t->end.begin() + k + 1, t->end.end());
+  int i = t->start[k];
+  t->start.resize(k);
+  t->end.resize(k);
+  setfont();
+  t->scan(this, i, pos + inserted, old_start, old_end, inserted - deleted);
+}
 
 /** \internal
   Converts a given text segment into the text that will be rendered on screen.
@@ -339,38 +463,35 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H, bool draw_active) {
   const char *p, *e;
   char buf[MAXBUF];
 
-  // count how many lines and put the last one into the buffer:
-  // And figure out where the cursor is:
+  // find the line with the cursor and put it into the buffer:
+  Line_Table *lt = line_table(1);
   int height = fl_height();
   int threshold = height/2;
-  int lines;
+  int lines = (int)lt->start.size();
+  int curline = lt->find(insert_position());
   int curx, cury;
-  for (p=value(), curx=cury=lines=0; ;) {
+  {
+    p = value() + lt->start[curline];
     e = expand(p, buf);
-    if (insert_position() >= p-value() && insert_position() <= e-value()) {
-      curx = int(expandpos(p, value()+insert_position(), buf, 0)+.5);
-      if (draw_active && !was_up_down) up_down_pos = curx;
-      cury = lines*height;
-      int newscroll = xscroll_;
-      if (curx > newscroll+W-threshold) {
-        // figure out scrolling so there is space after the cursor:
-        newscroll = curx+threshold-W;
-        // figure out the furthest left we ever want to scroll:
-        int ex = int(expandpos(p, e, buf, 0))+4-W;
-        // use minimum of both amounts:
-        if (ex < newscroll) newscroll = ex;
-      } else if (curx < newscroll+threshold) {
-        newscroll = curx-threshold;
-      }
-      if (newscroll < 0) newscroll = 0;
-      if (newscroll != xscroll_) {
-        xscroll_ = newscroll;
-        mu_p = 0; erase_cursor_only = 0;
-      }
+    curx = int(expandpos(p, value()+insert_position(), buf, 0)+.5);
+    if (draw_active && !was_up_down) up_down_pos = curx;
+    cury = curline*height;
+    int newscroll = xscroll_;
+    if (curx > newscroll+W-threshold) {
+      // figure out scrolling so there is space after the cursor:
+      newscroll = curx+threshold-W;
+      // figure out the furthest left we ever want to scroll:
+      int ex = int(expandpos(p, e, buf, 0))+4-W;
+      // use minimum of both amounts:
+      if (ex < newscroll) newscroll = ex;
+    } else if (curx < newscroll+threshold) {
+      newscroll = curx-threshold;
+    }
+    if (newscroll < 0) newscroll = 0;
+    if (newscroll != xscroll_) {
+      xscroll_ = newscroll;
+      mu_p = 0; erase_cursor_only = 0;
     }
-    lines++;
-    if (e >= value_+size_) break;
-    p = e+1;
   }
 
   // adjust the scrolling:
@@ -387,16 +508,20 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H, bool draw_active) {
   fl_push_clip(X, Y, W, H);
   Fl_Color tc = active_r() ? textcolor() : fl_inactive(textcolor());
 
-  p = value();
-  // visit each line and draw it:
+  // visit each visible line and draw it:
   int desc = height-fl_descent();
   float xpos = (float)(X - xscroll_ + 1);
-  int ypos = -yscroll_;
+  int line = yscroll_ > 0 ? yscroll_/height : 0;
+  if (line > lines-1) line = lines-1;
+  int ypos = line*height - yscroll_;
   int ypos_cur = 0; //fix issue #270
+  int inbuf = curline;
   for (; ypos < H;) {
 
-    // re-expand line unless it is the last one calculated above:
-    if (lines>1) e = expand(p, buf);
+    // expand the line unless it is still in the buffer:
+    p = value() + lt->start[line];
+    if (line != inbuf) {e = expand(p, buf); inbuf = line;}
+    else e = value() + lt->end[line];
 
     if (ypos <= -height) goto CONTINUE; // clipped off top
 
@@ -493,9 +618,7 @@ void Fl_Input_::drawtext(int X, int Y, int W, int H, bool draw_active) {
 
   CONTINUE:
     ypos += height;
-    if (e >= value_+size_) break;
-    if (*e == '\n' || *e == ' ') e++;
-    p = e;
+    if (++line >= lines) break;
   }
 
   // for minimal update, erase all lines below last one if necessary:
@@ -576,6 +699,8 @@ int Fl_Input_::line_end(int i) const {
   if (input_type() != FL_MULTILINE_INPUT) return size();
 
   if (wrap()) {
+    Line_Table *lt = line_table(0);
+    if (lt) return lt->end[lt->find(i)];
     // go to the start of the paragraph:
     int j = i;
     while (j > 0 && index(j-1) != '\n') j--;
@@ -605,6 +730,10 @@ int Fl_Input_::line_end(int i) const {
 */
 int Fl_Input_::line_start(int i) const {
   if (input_type() != FL_MULTILINE_INPUT) return 0;
+  if (wrap()) {
+    Line_Table *lt = line_table(0);
+    if (lt) return lt->start[lt->find(i)];
+  }
   int j = i;
   while (j > 0 && index(j-1) != '\n') j--;
   if (wrap()) {
@@ -649,12 +778,11 @@ void Fl_Input_::handle_mouse(int X, int Y, int /*W*/, int /*H*/, int drag) {
     (Fl::event_y()-Y+yscroll_)/fl_height() : 0;
 
   int newpos = 0;
-  for (p=value();; ) {
-    e = expand(p, buf);
-    theline--; if (theline < 0) break;
-    if (e >= value_+size_) break;
-    p = e+1;
-  }
+  Line_Table *lt = line_table(1);
+  if (theline < 0) theline = 0;
+  if (theline >= (int)lt->start.size()) theline = (int)lt->start.size() - 1;
+  p = value() + lt->start[theline];
+  e = expand(p, buf);
   const char *l, *r, *t; double f0 = Fl::event_x()-X+xscroll_;
   for (l = p, r = e; l<r; ) {
     double f;
@@ -921,30 +1049,33 @@ int Fl_Input_::replace(int b, int e, const char* text, int ilen) {
   if (e<=b && !ilen) return 0; // don't clobber undo for a null operation
 
   // we must count UTF-8 *characters* to determine whether we can insert
-  // the full text or only a part of it (and how much this would be)
-
-  int nchars = 0;       // characters in value() - deleted + inserted
-  const char *p = value_;
-  while (p < (char *)(value_+size_)) {
-    if (p == (char *)(value_+b)) { // skip removed part
-      p = (char *)(value_+e);
-      if (p >= (char *)(value_+size_)) break;
+  // the full text or only a part of it (and how much this would be),
+  // unless the new text has no more bytes than the maximum size
+
+  if (size_-(e-b)+ilen > maximum_size()) {
+    int nchars = 0;       // characters in value() - deleted + inserted
+    const char *p = value_;
+    while (p < (char *)(value_+size_)) {
+      if (p == (char *)(value_+b)) { // skip removed part
+        p = (char *)(value_+e);
+        if (p >= (char *)(value_+size_)) break;
+      }
+      int ulen = fl_utf8len(*p);
+      if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
+      nchars++;
+      p += ulen;
     }
-    int ulen = fl_utf8len(*p);
-    if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
-    nchars++;
-    p += ulen;
-  }
-  int nlen = 0;         // length (in bytes) to be inserted
-  p = text;
-  while (p < (char *)(text+ilen) && nchars < maximum_size()) {
-    int ulen = fl_utf8len(*p);
-    if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
-    nchars++;
-    p += ulen;
-    nlen += ulen;
+    int nlen = 0;         // length (in bytes) to be inserted
+    p = text;
+    while (p < (char *)(text+ilen) && nchars < maximum_size()) {
+      int ulen = fl_utf8len(*p);
+      if (ulen < 1) ulen = 1; // invalid UTF-8 character: count as 1
+      nchars++;
+      p += ulen;
+      nlen += ulen;
+    }
+    ilen = nlen;
   }
-  ilen = nlen;
 
   put_in_buffer(size_+ilen);
 
@@ -989,6 +1120,7 @@ int Fl_Input_::replace(int b, int e, const char* text, int ilen) {
     memcpy(buffer+b, text, ilen);
     size_ += ilen;
   }
+  lines_changed(b, e-b, ilen);
   om = mark_;
   op = position_;
   mark_ = position_ = undo_->undoat = b+ilen;
@@ -1055,6 +1187,7 @@ int Fl_Input_::apply_undo() {
     memmove(buffer+b, buffer+b+xlen, size_-xlen-b+1);
     size_ -= xlen;
   }
+  lines_changed(b1, xlen, ilen);
 
   undo_->undocut = xlen;
   if (xlen) undo_->undoyankcut = xlen;
@@ -1310,6 +1443,7 @@ Fl_Input_::Fl_Input_(int X, int Y, int W, int H, const char* l)
   shortcut_ = 0;
   undo_list_ = new Fl_Input_Undo_Action_List();
   redo_list_ = new Fl_Input_Undo_Action_List();
+  lines_ = 0;
   undo_ = new Fl_Input_Undo_Action();
   set_flag(SHORTCUT_LABEL);
   set_flag(MAC_USE_ACCENTS_MENU);
@@ -1380,6 +1514,7 @@ int Fl_Input_::static_value(const char* str, int len) {
   undo_->clear();
   undo_list_->clear();
   redo_list_->clear();
+  if (lines_) lines_->start.clear();
   if (str == value_ && len == size_) return 0;
   if (len) { // non-empty new value:
     if (xscroll_ || yscroll_) {
@@ -1530,6 +1665,7 @@ void Fl_Input_::resize(int X, int Y, int W, int H) {
 Fl_Input_::~Fl_Input_() {
   delete undo_list_;
   delete redo_list_;
+  delete lines_;
   delete undo_;
   if (bufsize) free((void*)buffer);
 }
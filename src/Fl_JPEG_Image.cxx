@@ -104,6 +104,34 @@ Fl_JPEG_Image::Fl_JPEG_Image(const char *filename)
   load_jpg_(filename, 0L, 0L);
 }
 
+/**
+ \brief The constructor loads a reduced JPEG image for a thumbnail of the given size.
+
+ The image is decoded at 1/2, 1/4 or 1/8 of its full size when the decoded
+ image is still at least \p W x \p H pixels large. libjpeg scales the image
+ while it decodes it, which is much faster than decoding the full image and
+ scaling it afterwards. Images smaller than twice the requested size are
+ decoded at full size.
+
+ The data of the image, see data_w() and data_h(), have the reduced size,
+ whereas w() and h() return the full size of the JPEG image, as if scale()
+ had been called. Use scale() or copy() to draw the image at thumbnail size.
+
+ Fl_Shared_Image::get(const char *, int, int) uses this constructor when
+ the image is not yet in the pool of shared images.
+
+ \param[in] filename a full path and name pointing to a valid jpeg file.
+ \param[in] W, H minimum size of the decoded image, 0 for the full size
+
+ \see Fl_JPEG_Image::Fl_JPEG_Image(const char *filename)
+ \since 1.5.0
+ */
+Fl_JPEG_Image::Fl_JPEG_Image(const char *filename, int W, int H)
+: Fl_RGB_Image(0,0,0)
+{
+  load_jpg_(filename, 0L, 0L, -1, W, H);
+}
+
 /**
  \brief The constructor loads the JPEG image from memory.
 
@@ -233,14 +261,16 @@ struct load_stat {
  This method reads JPEG image data and creates an RGB or grayscale image.
  To avoid code duplication, we set filename if we want to read from a file
  or data to read from memory instead. Sharename can be set if the image is
- supposed to be added to the Fl_Shared_Image list.
+ supposed to be added to the Fl_Shared_Image list. If W and H are set, the
+ image is decoded at the smallest DCT scale that is at least W x H pixels.
  */
-void Fl_JPEG_Image::load_jpg_(const char *filename, const char *sharename, const unsigned char *data, int data_length)
+void Fl_JPEG_Image::load_jpg_(const char *filename, const char *sharename, const unsigned char *data, int data_length,
+                              int W, int H)
 {
 #ifdef HAVE_LIBJPEG
   jpeg_decompress_struct  dinfo;    // Decompressor info
   fl_jpeg_error_mgr       jerr;     // Error handler info
-  JSAMPROW                row;      // Sample row pointer
+  JSAMPROW                rows[16]; // Sample row pointers
 
   struct load_stat *lstat = new load_stat();
 
@@ -314,6 +344,25 @@ void Fl_JPEG_Image::load_jpg_(const char *filename, const char *sharename, const
   dinfo.out_color_components = 3;
   dinfo.output_components    = 3;
 
+  // Find the smallest scale that is at least W x H pixels large
+  int denom = 1;
+  if (W > 0 && H > 0) {
+    for (denom = 8; denom > 1; denom /= 2) {
+      dinfo.scale_num   = 1;
+      dinfo.scale_denom = denom;
+      jpeg_calc_output_dimensions(&dinfo);
+      if ((int)dinfo.output_width >= W && (int)dinfo.output_height >= H)
+        break;
+    }
+    dinfo.scale_num   = 1;
+    dinfo.scale_denom = denom;
+    if (denom > 1) {
+      // reduced images are used as thumbnails, favor speed over accuracy
+      dinfo.dct_method          = JDCT_IFAST;
+      dinfo.do_fancy_upsampling = (boolean)FALSE;
+    }
+  }
+
   jpeg_calc_output_dimensions(&dinfo);
 
   w(dinfo.output_width);
@@ -326,18 +375,28 @@ void Fl_JPEG_Image::load_jpg_(const char *filename, const char *sharename, const
 
   jpeg_start_decompress(&dinfo);
 
+  // Read as many scanlines per call as the decompressor can deliver
+  const int max_rows = (int)(sizeof(rows) / sizeof(rows[0]));
   while (dinfo.output_scanline < dinfo.output_height) {
-    row = (JSAMPROW)(array +
-                     dinfo.output_scanline * dinfo.output_width *
-                     dinfo.output_components);
-    jpeg_read_scanlines(&dinfo, &row, (JDIMENSION)1);
+    int n = (int)(dinfo.output_height - dinfo.output_scanline);
+    if (n > max_rows) n = max_rows;
+    for (int i = 0; i < n; i++)
+      rows[i] = (JSAMPROW)(array +
+                           (dinfo.output_scanline + i) * dinfo.output_width *
+                           dinfo.output_components);
+    jpeg_read_scanlines(&dinfo, rows, (JDIMENSION)n);
   }
 
+  int full_w = (int)dinfo.image_width, full_h = (int)dinfo.image_height;
+
   jpeg_finish_decompress(&dinfo);
   jpeg_destroy_decompress(&dinfo);
 
   delete lstat;
 
+  // a reduced image keeps the drawing size of the full image
+  if (denom > 1) scale(full_w, full_h, 0, 1);
+
   if (sharename && w() && h()) {
     Fl_Shared_Image *si = new Fl_Shared_Image(sharename, this);
     si->add();
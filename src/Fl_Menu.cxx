@@ -29,6 +29,8 @@
 #include <stdio.h>
 #include "flstring.h"
 
+#include <vector>
+
 // This file will declare:
 class Menu_Window_Basetype;
 class Menu_Title_Window;
@@ -307,6 +309,17 @@ public:
   // Fake runtime type information
   Menu_Window* as_menuwindow() override { return this; }
 
+  // Return the visible item at index n, the terminating item if n is
+  // num_items, or nullptr if n is -1.
+  const Fl_Menu_Item* item(item_index_t n) const {
+    if (n < 0) return nullptr;
+    if (n < (item_index_t)items.size()) return items[n];
+    return menu ? menu->next(n) : nullptr;
+  }
+
+  // Pointers to all visible menu items in the window, in order.
+  std::vector<const Fl_Menu_Item*> items;
+
   // Optional title for menubar windows and floating menus
   Menu_Title_Window* title { nullptr };
 
@@ -334,6 +347,11 @@ public:
 
   // Used by the window driver
   int offset_y { 0 };
+
+  // Vertical range of the screen area for menus, used to skip drawing
+  // the items of tall menus that are outside of the screen.
+  int screen_top { 0 };
+  int screen_bottom { 0 };
 };
 
 //
@@ -371,7 +389,7 @@ void Menu_State::set_current_item(const Fl_Menu_Item* i, menu_index_t m, item_in
   \param[in] n index into visible item in that menu window
 */
 void Menu_State::set_current_item(menu_index_t m, item_index_t n) {
-  current_item = (n >= 0) ? menu_window[m]->menu->next(n) : 0;
+  current_item = menu_window[m]->item(n);
   current_menu_ix = m;
   current_item_ix = n;
 }
@@ -390,7 +408,7 @@ bool Menu_State::next_item(menu_index_t menu) { // go to next item in menu menu
   bool wrapped = false;
   do {
     while (++item < m.num_items) {
-      const Fl_Menu_Item* m1 = m.menu->next(item);
+      const Fl_Menu_Item* m1 = m.item(item);
       if (m1->selectable()) {
         set_current_item(m1, menu, item);
         return true;
@@ -418,7 +436,7 @@ bool Menu_State::prev_item(menu_index_t menu) { // previous item in menu menu if
   bool wrapped = false;
   do {
     while (--item >= 0) {
-      const Fl_Menu_Item* m1 = m.menu->next(item);
+      const Fl_Menu_Item* m1 = m.item(item);
       if (m1->selectable()) {
         set_current_item(m1, menu, item);
         return true;
@@ -730,6 +748,61 @@ Fl_Window *Menu_Window::parent_ = nullptr;
 int Menu_Window::display_height_ = 0;
 
 
+/* Measurements of all items of a menu window.
+ Measuring the labels and shortcuts of every item takes a noticeable time
+ for menus with thousands of items, so the results are kept for the menus
+ opened last, and reused if the items, the menu widget, and the screen scale
+ are the same when the menu opens again.
+ */
+struct Menu_Metrics {
+  const Fl_Menu_Item* first { nullptr };
+  const Fl_Menu_* button { nullptr };
+  item_index_t num_items { 0 };
+  unsigned long long hash { 0 };
+  int item_height { 0 };
+  int label_w { 0 };      // maximum width of all labels, including submenu arrows
+  int shortcuts_w { 0 };  // maximum width of all shortcut texts w/o modifiers
+  int modifiers_w { 0 };  // maximum width of all shortcut modifiers texts
+};
+
+static Menu_Metrics menu_metrics[8];
+static int menu_metrics_next = 0;
+
+/* Hash all item properties that are used to measure the menu.
+ \param[in] items visible items of the menu
+ \param[in] scale screen scale factor of the menu window
+ \param[out] hash combined hash value
+ \return false if the menu can not be cached, because an item uses a label
+    type that does not store a text in the item, e.g. an image label
+ */
+static bool hash_menu_items(const std::vector<const Fl_Menu_Item*> &items,
+                            float scale, unsigned long long &hash) {
+  unsigned long long h = 14695981039346656037ULL; // FNV-1a
+  #define HASH_VALUE(v) h = (h ^ (unsigned long long)(v)) * 1099511628211ULL
+  HASH_VALUE(Fl::menu_linespacing());
+  HASH_VALUE(scale * 1000);
+  if (button) {
+    HASH_VALUE(button->textfont());
+    HASH_VALUE(button->textsize());
+  }
+  for (const Fl_Menu_Item* m : items) {
+    if (m->labeltype_ >= _FL_MULTI_LABEL)
+      return false;
+    for (const char *t = m->text; *t; t++)
+      HASH_VALUE((uchar)*t);
+    HASH_VALUE(0x100); // end of text
+    HASH_VALUE(m->flags);
+    HASH_VALUE(m->labeltype_);
+    HASH_VALUE(m->labelfont_);
+    HASH_VALUE(m->labelsize_);
+    HASH_VALUE(m->shortcut_);
+  }
+  #undef HASH_VALUE
+  hash = h;
+  return true;
+}
+
+
 /*
  Construct a menu window that can render a list of menu items.
  \param[in] m pointer to the first menu item in the array
@@ -781,6 +854,7 @@ Menu_Window::Menu_Window(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
         }
       }
       if (!m1->text) break;
+      items.push_back(m1);
     }
     num_items = j;
   }
@@ -799,18 +873,34 @@ Menu_Window::Menu_Window(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
   int title_h = 0;      // height of the title window
   if (t) titile_w = t->measure(&title_h, button) + 12;
   int W = 0;
-  if (m) for (; m->text; m = m->next()) {
+  unsigned long long hash = 0;
+  bool cacheable = num_items > 0 && hash_menu_items(items, Fl::screen_scale(n), hash);
+  Menu_Metrics *mm = nullptr;
+  if (cacheable) {
+    for (Menu_Metrics &c : menu_metrics) {
+      if (c.first == items[0] && c.button == button && c.num_items == num_items && c.hash == hash) {
+        mm = &c;
+        break;
+      }
+    }
+  }
+  if (mm) {
+    item_height = mm->item_height;
+    W = mm->label_w;
+    shortcuts_w = mm->shortcuts_w;
+    modifiers_w = mm->modifiers_w;
+  } else for (const Fl_Menu_Item* mi : items) {
     int hh;
-    int w1 = m->measure(&hh, button);
+    int w1 = mi->measure(&hh, button);
     if (hh+Fl::menu_linespacing()>item_height) item_height = hh+Fl::menu_linespacing();
-    if (m->flags&(FL_SUBMENU|FL_SUBMENU_POINTER))
+    if (mi->flags&(FL_SUBMENU|FL_SUBMENU_POINTER))
       w1 += FL_NORMAL_SIZE;
     if (w1 > W) W = w1;
     // calculate the maximum width of all shortcuts
-    if (m->shortcut_) {
+    if (mi->shortcut_) {
       // s is a pointer to the UTF-8 string for the entire shortcut
       // k points only to the key part (minus the modifier keys)
-      const char *k, *s = fl_shortcut_label(m->shortcut_, &k);
+      const char *k, *s = fl_shortcut_label(mi->shortcut_, &k);
       if (fl_utf_nb_char((const unsigned char*)k, (int) strlen(k))<=4) {
         // a regular shortcut has a right-justified modifier followed by a left-justified key
         w1 = int(fl_width(s, (int) (k-s)));
@@ -826,6 +916,18 @@ Menu_Window::Menu_Window(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
       }
     }
   }
+  if (cacheable && !mm) {
+    Menu_Metrics &c = menu_metrics[menu_metrics_next];
+    menu_metrics_next = (menu_metrics_next + 1) % (int)(sizeof(menu_metrics)/sizeof(menu_metrics[0]));
+    c.first = items[0];
+    c.button = button;
+    c.num_items = num_items;
+    c.hash = hash;
+    c.item_height = item_height;
+    c.label_w = W;
+    c.shortcuts_w = shortcuts_w;
+    c.modifiers_w = modifiers_w;
+  }
   shortcut_width = shortcuts_w;
   if (selected >= 0 && !Wp) X -= W/2;
   int BW = Fl::box_dx(box());
@@ -838,6 +940,8 @@ Menu_Window::Menu_Window(const Fl_Menu_Item* m, int X, int Y, int Wp, int Hp,
   // but it makes right_edge argument useless
   //if (X > scr_x+scr_w-W) X = right_edge-W;
   if (X > scr_x+scr_w-W) X = scr_x+scr_w-W;
+  screen_top = scr_y;
+  screen_bottom = scr_y+scr_h;
   x(X); w(W);
   h((num_items ? item_height*num_items-4 : 0)+2*BW+3);
   if (selected >= 0) {
@@ -988,13 +1092,13 @@ int Menu_Window::handle_part2(int e, int ret) {
 void Menu_Window::set_selected(item_index_t n) {
   if (n != selected) {
     if ((selected!=-1) && (menu)) {
-      const Fl_Menu_Item *mi = menu->next(selected);
+      const Fl_Menu_Item *mi = item(selected);
       if ((mi) && (mi->callback_) && (mi->flags & FL_MENU_CHATTY))
         mi->do_callback(this, FL_REASON_LOST_FOCUS);
     }
     selected = n;
     if ((selected!=-1) && (menu)) {
-      const Fl_Menu_Item *mi = menu->next(selected);
+      const Fl_Menu_Item *mi = item(selected);
       if ((mi) && (mi->callback_) && (mi->flags & FL_MENU_CHATTY))
         mi->do_callback(this, FL_REASON_GOT_FOCUS);
     }
@@ -1048,6 +1152,8 @@ void Menu_Window::autoscroll(item_index_t n) {
 
   int xx, ww;
   Fl_Window_Driver::driver(this)->menu_window_area(xx, scr_y, ww, scr_h, this->screen_num());
+  screen_top = scr_y;
+  screen_bottom = scr_y+scr_h;
   if (n==0 && Y <= scr_y + item_height) {
     Y = scr_y - Y + 10;
   } else if (Y <= scr_y + item_height) {
@@ -1188,15 +1294,32 @@ void Menu_Window::draw() {
     }
     fl_draw_box(box(), 0, 0, w(), h(), button ? button->color() : color());
     if (menu) {
-      const Fl_Menu_Item* m; int j;
-      for (m=menu->first(), j=0; m->text; j++, m = m->next())
-        draw_entry(m, j, 0);
+      // Draw only the items that intersect the clip region and the screen.
+      // Tall menus with many items are larger than the screen and are
+      // moved by autoscroll().
+      item_index_t first = 0, last = num_items-1;
+      if (item_height && num_items) {
+        int cx, cy, cw, ch;
+        fl_clip_box(0, 0, w(), h(), cx, cy, cw, ch);
+        int top = cy, bottom = cy+ch;
+        if (screen_bottom > screen_top) {
+          if (top < screen_top-y()) top = screen_top-y();
+          if (bottom > screen_bottom-y()) bottom = screen_bottom-y();
+        }
+        int dy = Fl::box_dy(box()) + 1;
+        first = (top-dy)/item_height - 1;
+        last = (bottom-dy)/item_height + 1;
+        if (first < 0) first = 0;
+        if (last > num_items-1) last = num_items-1;
+      }
+      for (item_index_t j = first; j <= last; j++)
+        draw_entry(item(j), j, 0);
     }
   } else {
     if (damage() & FL_DAMAGE_CHILD && selected!=drawn_selected) {
       // change selection
-      draw_entry(menu->next(drawn_selected), drawn_selected, 1);
-      draw_entry(menu->next(selected), selected, 1);
+      draw_entry(item(drawn_selected), drawn_selected, 1);
+      draw_entry(item(selected), selected, 1);
     }
   }
   drawn_selected = selected;
@@ -27,6 +27,95 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern int fl_shortcut_keys(unsigned int keys[3]); // in fl_shortcut.cxx
+
+// Maps menu pathnames to indexes into the menu array, see path_index()
+class Fl_Menu_::Path_Index {
+public:
+  Path_Index() : valid(false) {}
+  bool valid;
+  std::unordered_map<std::string, int> paths;
+};
+
+// Maps the keys of item shortcuts to menu items, see shortcut_index()
+class Fl_Menu_::Shortcut_Index {
+public:
+  struct Node {
+    const Fl_Menu_Item *item;
+    int parent;                 // node of the submenu title, or -1
+  };
+  Shortcut_Index() : valid(false), menu(NULL) {}
+  bool valid;
+  const Fl_Menu_Item *menu;     // the menu array the index was built for
+  // All items in the order Fl_Menu_Item::test_shortcut() visits them: the
+  // items of a menu level first, followed by the items of its submenus.
+  std::vector<Node> nodes;
+  std::unordered_map<unsigned int, std::vector<int> > keys; // key -> nodes
+  void build(const Fl_Menu_Item *m, int parent);
+  bool active(int n) const;
+  const Fl_Menu_Item *find() const;
+};
+
+// Returns the item after m on the same menu level
+static const Fl_Menu_Item *next_on_level(const Fl_Menu_Item *m) {
+  int nest = 0;
+  do {
+    if (!m->text) nest--;
+    else if (m->flags & FL_SUBMENU) nest++;
+    m++;
+  } while (nest > 0);
+  return m;
+}
+
+void Fl_Menu_::Shortcut_Index::build(const Fl_Menu_Item *m, int parent) {
+  if (!m) return;
+  int first = (int)nodes.size();
+  for (; m->text; m = next_on_level(m)) {
+    Node n = { m, parent };
+    nodes.push_back(n);
+    if (m->shortcut_)
+      keys[m->shortcut_ & FL_KEY_MASK].push_back((int)nodes.size() - 1);
+  }
+  int last = (int)nodes.size();
+  for (int i = first; i < last; i++) {
+    const Fl_Menu_Item *t = nodes[i].item;
+    if (t->flags & FL_SUBMENU) build(t + 1, i);
+    else if (t->flags & FL_SUBMENU_POINTER) build((const Fl_Menu_Item*)t->user_data_, i);
+  }
+}
+
+// Items are active if they and all their submenu titles are active
+bool Fl_Menu_::Shortcut_Index::active(int n) const {
+  for (; n >= 0; n = nodes[n].parent)
+    if (!nodes[n].item->active()) return false;
+  return true;
+}
+
+// Returns the first item in test_shortcut() order that matches the current
+// event. Only the items whose shortcut has one of the keys the event can
+// match are tested.
+const Fl_Menu_Item *Fl_Menu_::Shortcut_Index::find() const {
+  unsigned int k[3];
+  int nk = fl_shortcut_keys(k);
+  int best = -1;
+  for (int i = 0; i < nk; i++) {
+    std::unordered_map<unsigned int, std::vector<int> >::const_iterator it = keys.find(k[i]);
+    if (it == keys.end()) continue;
+    const std::vector<int> &v = it->second;
+    for (size_t j = 0; j < v.size() && (best < 0 || v[j] < best); j++) {
+      if (Fl::test_shortcut(nodes[v[j]].item->shortcut_) && active(v[j])) {
+        best = v[j];
+        break;
+      }
+    }
+  }
+  return best < 0 ? NULL : nodes[best].item;
+}
+
 #define SAFE_STRCAT(s) { len += (int) strlen(s); if ( len >= namelen ) { *name='\0'; return(-2); } else strcat(name,(s)); }
 
 /** Get the menu 'pathname' for the specified menuitem.
@@ -74,7 +163,8 @@ int Fl_Menu_::item_pathname_(char *name,
   int level = 0;
   finditem = finditem ? finditem : mvalue();
   menu = menu ? menu : this->menu();
-  for ( int t=0; t<size(); t++ ) {
+  int n = size();
+  for ( int t=0; t<n; t++ ) {
     const Fl_Menu_Item *m = menu + t;
     if (m->submenu()) {                         // submenu? descend
       if (m->flags & FL_SUBMENU_POINTER) {
@@ -196,7 +286,8 @@ int Fl_Menu_::find_index(const Fl_Menu_Item *item) const {
  \see      find_index(const char*)
  */
 int Fl_Menu_::find_index(Fl_Callback *cb) const {
-  for ( int t=0; t < size(); t++ )
+  int n = size();
+  for ( int t=0; t < n; t++ )
     if (menu_[t].callback_==cb)
       return(t);
   return(-1);
@@ -216,15 +307,43 @@ int Fl_Menu_::find_index(Fl_Callback *cb) const {
 
 */
 int Fl_Menu_::find_index(const char *pathname) const {
+  if (path_index_) {
+    for (int pass = 0; pass < 2; pass++) {
+      if (!path_index_->valid) {
+        path_index_->paths.clear();
+        find_index_(0); // fill the index
+        path_index_->valid = true;
+      }
+      std::unordered_map<std::string, int>::const_iterator it = path_index_->paths.find(pathname);
+      if (it == path_index_->paths.end())
+        return -1;
+      // check that the item label is still the last part of the pathname
+      const char *label = menu_[it->second].label();
+      size_t ll = label ? strlen(label) : 0, pl = strlen(pathname);
+      if (label && ll <= pl && !strcmp(pathname + pl - ll, label) &&
+          (ll == pl || pathname[pl - ll - 1] == '/'))
+        return it->second;
+      path_index_->valid = false; // the menu was changed, rebuild the index
+    }
+    return -1;
+  }
+  return find_index_(pathname);
+}
+
+// INTERNAL: Find the index of a pathname with a linear search,
+// or add all pathnames to the path index if pathname is NULL.
+int Fl_Menu_::find_index_(const char *pathname) const {
   char menupath[1024] = "";     // File/Export
-  for ( int t=0; t < size(); t++ ) {
+  int n = size();
+  for ( int t=0; t < n; t++ ) {
     Fl_Menu_Item *m = menu_ + t;
     if (m->flags&FL_SUBMENU) {
       // IT'S A SUBMENU
       // we do not support searches through FL_SUBMENU_POINTER links
       if (menupath[0]) strlcat(menupath, "/", sizeof(menupath));
-      strlcat(menupath, m->label(), sizeof(menupath));
-      if (!strcmp(menupath, pathname)) return(t);
+      if (m->label()) strlcat(menupath, m->label(), sizeof(menupath));
+      if (!pathname) path_index_->paths.emplace(menupath, t);
+      else if (!strcmp(menupath, pathname)) return(t);
     } else {
       if (!m->label()) {
         // END OF SUBMENU? Pop back one level.
@@ -238,12 +357,108 @@ int Fl_Menu_::find_index(const char *pathname) const {
       strcpy(itempath, menupath);
       if (itempath[0]) strlcat(itempath, "/", sizeof(itempath));
       strlcat(itempath, m->label(), sizeof(itempath));
-      if (!strcmp(itempath, pathname)) return(t);
+      if (!pathname) path_index_->paths.emplace(itempath, t);
+      else if (!strcmp(itempath, pathname)) return(t);
     }
   }
   return(-1);
 }
 
+/**
+ Enables or disables a hash index for find_index(const char*) and find_item(const char*).
+
+ Without the index, these methods compare the pathnames of all items with the
+ requested pathname, which is slow for menus with many thousands of items.
+ The index is built when a pathname is searched first, and it is rebuilt
+ after the menu was changed with add(), insert(), remove(), replace() and
+ other methods of this class.
+
+ If item labels are changed directly, e.g. with Fl_Menu_Item::label(),
+ call path_index(1) again to rebuild the index.
+
+ \param[in] onoff 1 to enable, 0 to disable the index
+ \see path_index() const, add_batch()
+ \since 1.5.0
+ */
+void Fl_Menu_::path_index(int onoff) {
+  if (onoff) {
+    if (!path_index_) path_index_ = new Path_Index;
+    path_index_->valid = false;
+  } else {
+    delete path_index_;
+    path_index_ = NULL;
+  }
+}
+
+/**
+ Returns 1 if the pathname index is enabled.
+ \see path_index(int)
+ \since 1.5.0
+ */
+int Fl_Menu_::path_index() const {
+  return path_index_ != NULL;
+}
+
+/**
+ Enables or disables a shortcut index for test_shortcut().
+
+ Without the index, test_shortcut() tests the shortcuts of all menu items
+ against each FL_SHORTCUT event, which is slow for menus with thousands
+ of items. The index maps the key of each item shortcut to the items and
+ is built when a shortcut is tested first. It is rebuilt after the menu
+ was changed with add(), insert(), remove(), replace(), shortcut(int, int)
+ and other methods of this class. The items found are the same as without
+ the index.
+
+ If item shortcuts are changed directly, e.g. with Fl_Menu_Item::shortcut(),
+ call shortcut_index(1) again to rebuild the index.
+
+ Fl_Window::add_shortcut() avoids sending the event to all widgets of a
+ window before it reaches the menu.
+
+ \param[in] onoff 1 to enable, 0 to disable the index
+ \see shortcut_index() const
+ \since 1.5.0
+ */
+void Fl_Menu_::shortcut_index(int onoff) {
+  if (onoff) {
+    if (!shortcut_index_) shortcut_index_ = new Shortcut_Index;
+    shortcut_index_->valid = false;
+  } else {
+    delete shortcut_index_;
+    shortcut_index_ = NULL;
+  }
+}
+
+/**
+ Returns 1 if the shortcut index is enabled.
+ \see shortcut_index(int)
+ \since 1.5.0
+ */
+int Fl_Menu_::shortcut_index() const {
+  return shortcut_index_ != NULL;
+}
+
+const Fl_Menu_Item* Fl_Menu_::test_shortcut() {
+  if (!shortcut_index_)
+    return picked(menu()->test_shortcut());
+  // menu_ also changes when add() moves the array of another menu
+  if (!shortcut_index_->valid || shortcut_index_->menu != menu_) {
+    shortcut_index_->nodes.clear();
+    shortcut_index_->keys.clear();
+    shortcut_index_->build(menu_, -1);
+    shortcut_index_->menu = menu_;
+    shortcut_index_->valid = true;
+  }
+  return picked(shortcut_index_->find());
+}
+
+// INTERNAL: the menu array was changed, rebuild the indexes when needed
+void Fl_Menu_::indexes_changed_() const {
+  if (path_index_) path_index_->valid = false;
+  if (shortcut_index_) shortcut_index_->valid = false;
+}
+
 /**
  Find the menu item for the given callback \p cb.
 
@@ -257,7 +472,8 @@ int Fl_Menu_::find_index(const char *pathname) const {
  \see find_item(const char*)
  */
 const Fl_Menu_Item * Fl_Menu_::find_item(Fl_Callback *cb) {
-  for ( int t=0; t < size(); t++ ) {
+  int n = size();
+  for ( int t=0; t < n; t++ ) {
     const Fl_Menu_Item *m = menu_ + t;
     if (m->callback_==cb) {
       return m;
@@ -274,7 +490,8 @@ const Fl_Menu_Item * Fl_Menu_::find_item(Fl_Callback *cb) {
  \see find_item(const char*)
  */
 const Fl_Menu_Item* Fl_Menu_::find_item_with_user_data(void *v) {
-  for ( int t=0; t < size(); t++ ) {
+  int n = size();
+  for ( int t=0; t < n; t++ ) {
     const Fl_Menu_Item *m = menu_ + t;
     if (m->user_data_==v) {
       return m;
@@ -291,7 +508,8 @@ const Fl_Menu_Item* Fl_Menu_::find_item_with_user_data(void *v) {
  \see find_item(const char*)
  */
 const Fl_Menu_Item* Fl_Menu_::find_item_with_argument(long v) {
-  for ( int t=0; t < size(); t++ ) {
+  int n = size();
+  for ( int t=0; t < n; t++ ) {
     const Fl_Menu_Item *m = menu_ + t;
     if (m->argument()==v) {
       return m;
@@ -497,6 +715,8 @@ Fl_Menu_::Fl_Menu_(int X,int Y,int W,int H,const char* l)
   menu_(NULL),
   value_(NULL),
   prev_value_(NULL),
+  path_index_(NULL),
+  shortcut_index_(NULL),
   alloc(0),
   down_box_(FL_NO_BOX),
   menu_box_(FL_NO_BOX),
@@ -556,6 +776,8 @@ void Fl_Menu_::copy(const Fl_Menu_Item* m, void* ud) {
 
 Fl_Menu_::~Fl_Menu_() {
   clear();
+  delete path_index_;
+  delete shortcut_index_;
 }
 
 // Fl_Menu::add() uses this to indicate the owner of the dynamically-
@@ -605,6 +827,7 @@ void Fl_Menu_::clear() {
   }
   menu_ = 0;
   value_ = prev_value_ = 0;
+  indexes_changed_();
 }
 
 /**
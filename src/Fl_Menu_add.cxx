@@ -30,6 +30,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 // If the array is this, we will double-reallocate as necessary:
 static Fl_Menu_Item* local_array = 0;
 static int local_array_alloc = 0; // number allocated
@@ -417,6 +421,7 @@ int Fl_Menu_::insert(
     fl_menu_array_owner = this;
   }
   int r = menu_->insert(index,label,shortcut,callback,userdata,flags);
+  indexes_changed_();
   // if it rellocated array we must fix the pointer:
   int value_offset = (int) (value_-menu_);
   menu_ = local_array; // in case it reallocated it
@@ -461,6 +466,192 @@ int Fl_Menu_::add(const char *str) {
 
 
 
+// A menu item and its submenu items while a menu is built by add_batch()
+struct Batch_Node {
+  Fl_Menu_Item item;
+  int old_index;                  // index in the previous menu array or -1
+  int new_index;                  // index in the new menu array
+  std::vector<Batch_Node*> children;
+  bool indexed;                   // children are in the maps below
+  std::unordered_map<std::string, Batch_Node*> submenus, items;
+  Batch_Node() : old_index(-1), new_index(-1), indexed(false) {
+    memset(&item, 0, sizeof(item));
+  }
+  ~Batch_Node() {
+    for (size_t i = 0; i < children.size(); i++) delete children[i];
+  }
+  // name used to find items: like compare(), ignore '&' characters
+  static std::string key(const char *text) {
+    std::string k;
+    for (; *text; text++) if (*text != '&') k += *text;
+    return k;
+  }
+  void index_child(Batch_Node *c) {
+    if (c->item.flags & FL_SUBMENU) submenus.emplace(key(c->item.text), c);
+    else items.emplace(key(c->item.text), c);
+  }
+  // find the first submenu (or item) with the given name
+  Batch_Node *find(const char *text, bool submenu) {
+    if (!indexed) {
+      for (size_t i = 0; i < children.size(); i++) index_child(children[i]);
+      indexed = true;
+    }
+    std::unordered_map<std::string, Batch_Node*> &map = submenu ? submenus : items;
+    std::unordered_map<std::string, Batch_Node*>::iterator it = map.find(key(text));
+    return it == map.end() ? 0 : it->second;
+  }
+  Batch_Node *append(const char *text, int flags) {
+    Batch_Node *c = new Batch_Node;
+    c->item.text = fl_strdup(text);
+    c->item.flags = flags;
+    c->item.labelfont_ = FL_HELVETICA;
+    children.push_back(c);
+    if (indexed) index_child(c);
+    return c;
+  }
+  // read the items of a menu array up to its terminating item
+  void read(const Fl_Menu_Item *array, int &i) {
+    while (array[i].text) {
+      Batch_Node *c = new Batch_Node;
+      c->item = array[i];
+      c->old_index = i;
+      children.push_back(c);
+      i++;
+      if (c->item.flags & FL_SUBMENU) {
+        c->read(array, i);
+        i++; // skip the submenu terminator
+      }
+    }
+  }
+  // number of menu items needed for the children and the terminator
+  int count() const {
+    int n = 1;
+    for (size_t i = 0; i < children.size(); i++) {
+      n++;
+      if (children[i]->item.flags & FL_SUBMENU) n += children[i]->count();
+    }
+    return n;
+  }
+  void write(Fl_Menu_Item *array, int &i) {
+    for (size_t j = 0; j < children.size(); j++) {
+      Batch_Node *c = children[j];
+      c->new_index = i;
+      array[i++] = c->item;
+      if (c->item.flags & FL_SUBMENU) c->write(array, i);
+    }
+    memset(array + i++, 0, sizeof(Fl_Menu_Item));
+  }
+  void map_indexes(std::vector<int> &old_to_new) const {
+    for (size_t j = 0; j < children.size(); j++) {
+      if (children[j]->old_index >= 0)
+        old_to_new[children[j]->old_index] = children[j]->new_index;
+      children[j]->map_indexes(old_to_new);
+    }
+  }
+};
+
+
+/**
+  Adds many menu items at once.
+
+  The result is the same as calling add(label, shortcut, callback, user_data, flags)
+  with the text, shortcut, callback, user data, and flags of each item in
+  \p items in turn, including the interpretation of '/', '_', '&', and '\\'
+  in the text, but the menu array is created only once. Items with the same
+  path are found with a hash table. This makes building menus with many
+  thousands of items much faster than calling add() for each item.
+
+  Other members of the items in \p items are ignored. The texts are copied.
+
+  \note Fl_Sys_Menu_Bar::update() must be called after adding items to an
+    Fl_Sys_Menu_Bar with this method.
+
+  \param[in] items  array of items, the text of each item is the menu path
+  \param[in] n      number of items, or -1 to add all items up to an item
+                    with a NULL text
+  \returns the index into the menu() array of the last item added,
+    or -1 if no item was added
+  \see add(const char*, int, Fl_Callback*, void*, int), path_index()
+  \since 1.5.0
+*/
+int Fl_Menu_::add_batch(const Fl_Menu_Item *items, int n) {
+  if (n < 0) for (n = 0; items[n].text; n++) { }
+  if (n == 0) return -1;
+
+  // read the current menu into a tree
+  Batch_Node root;
+  int old_size = size();
+  if (menu_) {
+    int i = 0;
+    root.read(menu_, i);
+  }
+
+  // add all items, this is the same as Fl_Menu_Item::insert() with index -1
+  Batch_Node *last = 0;
+  for (int k = 0; k < n; k++) {
+    const Fl_Menu_Item &src = items[k];
+    if (!src.text) continue;
+    const char *mytext = src.text;
+    Batch_Node *node = &root;
+    int flags1 = 0;
+    std::string buf;
+    const char *item;
+    for (;;) {
+      // leading slash makes us assume it is a filename:
+      if (*mytext == '/') {item = mytext; break;}
+      // leading underscore causes divider line:
+      if (*mytext == '_') {mytext++; flags1 = FL_MENU_DIVIDER;}
+      // copy to buf, changing \x to x:
+      const char *p;
+      buf.clear();
+      for (p = mytext; *p && *p != '/'; p++) {
+        if (*p == '\\' && p[1]) p++;
+        buf += *p;
+      }
+      item = buf.c_str();
+      if (*p != '/') break; // not a menu title
+      mytext = p+1;         // point at item title
+      Batch_Node *sub = node->find(item, true);
+      if (!sub) sub = node->append(item, FL_SUBMENU|flags1);
+      node = sub;           // go into the submenu
+      flags1 = 0;
+    }
+    Batch_Node *m = node->find(item, false);
+    if (!m) m = node->append(item, src.flags|flags1);
+    m->item.shortcut_ = src.shortcut_;
+    m->item.callback_ = src.callback_;
+    m->item.user_data_ = src.user_data_;
+    m->item.flags = src.flags|flags1;
+    last = m;
+  }
+
+  // write the new menu array
+  int new_size = root.count();
+  Fl_Menu_Item *array = new Fl_Menu_Item[new_size];
+  int i = 0;
+  root.write(array, i);
+  std::vector<int> old_to_new(old_size > 0 ? old_size : 1, -1);
+  root.map_indexes(old_to_new);
+  int value_ix = (value_ && value_ >= menu_ && value_ < menu_ + old_size) ? old_to_new[value_ - menu_] : -1;
+  int prev_ix = (prev_value_ && prev_value_ >= menu_ && prev_value_ < menu_ + old_size) ? old_to_new[prev_value_ - menu_] : -1;
+
+  // replace the current menu array, the strings are now owned by the new array
+  int new_alloc = (menu_ && alloc < 2) ? 1 : 2; // see insert()
+  if (this == fl_menu_array_owner) {
+    fl_menu_array_owner = 0; // local_array is kept for the next add()
+  } else if (alloc) {
+    delete[] menu_;
+  }
+  menu_ = array;
+  alloc = new_alloc;
+  value_ = value_ix >= 0 ? menu_ + value_ix : 0;
+  prev_value_ = prev_ix >= 0 ? menu_ + prev_ix : 0;
+  indexes_changed_();
+
+  return last ? last->new_index : -1;
+}
+
+
 /**
   Changes the text of item \p i.  This is the only way to get
   slash into an add()'ed menu item.  If the menu array was directly set
@@ -477,6 +668,7 @@ void Fl_Menu_::replace(int i, const char *str) {
       str = fl_strdup(str?str:"");
   }
   menu_[i].text = str;
+  indexes_changed_();
 }
 
 
@@ -503,6 +695,7 @@ void Fl_Menu_::remove(int i) {
   }
   // MRS: "n" is the menu size(), which includes the trailing NULL entry...
   memmove(item, next_item, (menu_+n-next_item)*sizeof(Fl_Menu_Item));
+  indexes_changed_();
 }
 
 /**
@@ -28,7 +28,10 @@
 #include <stdlib.h>
 #include <stdarg.h>
 
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 /*
  The format of preferences files is not part of the FLTK specification
@@ -153,6 +156,7 @@ char Fl_Preferences::nameBuffer[128];
 char Fl_Preferences::uuidBuffer[40];
 Fl_Preferences *Fl_Preferences::runtimePrefs = 0;
 unsigned int Fl_Preferences::fileAccess_ = Fl_Preferences::ALL;
+int Fl_Preferences::binaryThreshold_ = 0;
 
 static int clocale_snprintf(char *buffer, size_t buffer_size, const char *format, ...)
 {
@@ -238,6 +242,45 @@ unsigned int Fl_Preferences::file_access()
     return fileAccess_;
 }
 
+/**
+ Set the size from which binary entries are stored in a separate file.
+
+ Binary data that is set with set(const char *entry, const void *value, int size)
+ is normally stored in the preferences file as hexadecimal text, which doubles
+ its size and must be decoded every time the preferences are read. If \p size
+ is larger than 0, binary values of at least \p size bytes are instead stored
+ in a file next to the preferences file, named like the preferences file with
+ the extension \c .blobs, and the text entry refers to the data in that file.
+
+ The binary file is only read when one of its values is needed. Its values
+ can be accessed without copying them with get_binary(). The file is removed
+ when the preferences are written and no entry refers to it anymore.
+
+ Preferences with the \c MEMORY root always store binary values as text. The default
+ is 0, which stores all binary values as text, so preference files can be
+ read by applications that use older versions of FLTK.
+
+ \param[in] size minimum size of binary values stored in the separate file,
+    or 0 to store all binary values as text
+ \see Fl_Preferences::binary_threshold()
+ \since 1.5.0
+ */
+void Fl_Preferences::binary_threshold(int size)
+{
+  binaryThreshold_ = size;
+}
+
+/**
+ Return the size from which binary entries are stored in a separate file.
+
+ \see Fl_Preferences::binary_threshold(int)
+ \since 1.5.0
+ */
+int Fl_Preferences::binary_threshold()
+{
+  return binaryThreshold_;
+}
+
 /**
  Determine the file name and path to preferences that would be opened with
  these parameters.
@@ -1043,6 +1086,26 @@ static void *decodeHex( const char *src, int &size ) {
   return (void*)data;
 }
 
+// check if an entry value refers to the binary file, and get the id and size
+static char parseBinaryRef( const char *src, unsigned &id, int &size ) {
+  return ( src[0] == '@' && sscanf( src, "@blob:%u:%d", &id, &size ) == 2 && size >= 0 );
+}
+
+// convert an entry value to binary data, which is either hex encoded or
+// a reference into the binary file; returns NULL if the data is missing
+static void *decodeBinary( Fl_Preferences::Node *node, const char *src, int &size ) {
+  unsigned id;
+  if ( parseBinaryRef( src, id, size ) ) {
+    Fl_Preferences::RootNode *root = node->findRoot();
+    const char *data = root ? root->getBinary( src, size ) : 0;
+    if ( !data ) return 0;
+    void *copy = malloc( size ? size : 1 );
+    memcpy( copy, data, size );
+    return copy;
+  }
+  return decodeHex( src, size );
+}
+
 /**
  Reads a binary entry from the group, encoded in hexadecimal blocks.
 
@@ -1058,9 +1121,9 @@ static void *decodeHex( const char *src, int &size ) {
  */
 char Fl_Preferences::get( const char *key, void *data, const void *defaultValue, int defaultSize, int maxSize ) {
   const char *v = node->get( key );
-  if ( v ) {
-    int dsize;
-    void *w = decodeHex( v, dsize );
+  int dsize;
+  void *w = v ? decodeBinary( node, v, dsize ) : 0;
+  if ( w ) {
     memmove( data, w, dsize>maxSize?maxSize:dsize );
     free( w );
     return 1;
@@ -1090,9 +1153,9 @@ char Fl_Preferences::get( const char *key, void *data, const void *defaultValue,
     return -1;
   int capacity = *maxSize;
   const char *v = node->get( key );
-  if ( v ) {
-    int nFound;
-    void *w = decodeHex( v, nFound );
+  int nFound;
+  void *w = v ? decodeBinary( node, v, nFound ) : 0;
+  if ( w ) {
     int nWrite = (nFound>capacity) ? capacity : nFound;
     memmove( data, w,  nWrite);
     free( w );
@@ -1124,11 +1187,10 @@ char Fl_Preferences::get( const char *key, void *data, const void *defaultValue,
  */
 char Fl_Preferences::get( const char *key, void *&data, const void *defaultValue, int defaultSize ) {
   const char *v = node->get( key );
-  if ( v ) {
-    int dsize;
-    data = decodeHex( v, dsize );
+  int dsize;
+  data = v ? decodeBinary( node, v, dsize ) : 0;
+  if ( data )
     return 1;
-  }
   if ( defaultValue ) {
     data = (void*)malloc( defaultSize );
     memmove( data, defaultValue, defaultSize );
@@ -1143,12 +1205,29 @@ char Fl_Preferences::get( const char *key, void *&data, const void *defaultValue
  was a problem storing the data in memory. However it does not
  reflect if the value was actually stored in the preference file.
 
+ Binary values are stored as hexadecimal text, or in a separate binary file
+ if they are larger than the size set with binary_threshold(int).
+
  \param[in] key name of entry
  \param[in] data set this entry to \p value
  \param[in] dsize size of data array
  \return 0 if setting the value failed
  */
 char Fl_Preferences::set( const char *key, const void *data, int dsize ) {
+  if ( binaryThreshold_ > 0 && dsize >= binaryThreshold_ ) {
+    RootNode *root = node->findRoot();
+    const char *v = node->get( key );
+    unsigned id;
+    int osize;
+    const char *old = ( root && v && parseBinaryRef( v, id, osize ) ) ? root->getBinary( v, osize ) : 0;
+    if ( old && osize == dsize && memcmp( old, data, dsize ) == 0 )
+      return 1;                 // unchanged, keep the entry clean
+    char ref[40];
+    if ( root && root->setBinary( data, dsize, ref, sizeof(ref) ) ) {
+      node->set( key, ref );
+      return 1;
+    }
+  }
   char *buffer = (char*)malloc( dsize*2+1 ), *d = buffer;;
   unsigned char *s = (unsigned char*)data;
   for ( ; dsize>0; dsize-- ) {
@@ -1181,14 +1260,52 @@ char Fl_Preferences::set( const char *entry, const std::string &value ) {
 /**
  Returns the size of the value part of an entry.
 
+ For binary entries, this is the size of the hexadecimal text, which is
+ twice the size of the data, also if the data is stored in the binary file.
+
  \param[in] key name of entry
  \return size of value
  */
 int Fl_Preferences::size( const char *key ) {
   const char *v = node->get( key );
+  unsigned id;
+  int dsize;
+  if ( v && parseBinaryRef( v, id, dsize ) )
+    return 2*dsize;
   return (int) (v ? strlen( v ) : 0);
 }
 
+/**
+ Reads a binary entry that is stored in the binary file without copying it.
+
+ This returns a pointer to the data of an entry that was stored in the
+ separate binary file, see binary_threshold(int). The binary file is read
+ when the first of its values is needed. Values that are stored as
+ hexadecimal text are not returned, use one of the get() methods that
+ copy binary data for these.
+
+ The data must not be modified. The pointer is valid until the entry is
+ changed, the preferences are written to disk, or the preferences database
+ is closed.
+
+ \param[in] key name of entry
+ \param[out] data pointer to the data, or NULL
+ \param[out] dsize size of the data in bytes, or 0
+ \return 0 if the entry does not exist or is not stored in the binary file
+ \since 1.5.0
+ */
+char Fl_Preferences::get_binary( const char *key, const void *&data, int &dsize ) {
+  const char *v = node->get( key );
+  RootNode *root = node->findRoot();
+  unsigned id;
+  data = 0;
+  if ( v && root && parseBinaryRef( v, id, dsize ) )
+    data = root->getBinary( v, dsize );
+  if ( !data )
+    dsize = 0;
+  return data != 0;
+}
+
 /**
  \brief Creates a path that is related to the preference file and
  that is usable for additional application data.
@@ -1329,6 +1446,199 @@ Fl_Preferences::Name::~Name() {
 
 int Fl_Preferences::Node::lastEntrySet = -1;
 
+// read the remaining contents of a file
+static void readFile( FILE *f, std::vector<char> &data ) {
+  char chunk[16384];
+  size_t n;
+  while ( (n = fread( chunk, 1, sizeof(chunk), f )) > 0 )
+    data.insert( data.end(), chunk, chunk+n );
+}
+
+// write a file to a temporary file and rename it when it is complete, so the
+// file is never left half written if the application or the system fails
+static int writeFileAtomic( const char *filename, const std::string &tmpname, FILE *f ) {
+  int err = ferror( f );
+  if ( fclose( f ) != 0 ) err = 1;
+  if ( !err && fl_rename( tmpname.c_str(), filename ) != 0 ) {
+    // Windows does not replace an existing file
+    fl_unlink( filename );
+    err = fl_rename( tmpname.c_str(), filename );
+  }
+  if ( err ) {
+    fl_unlink( tmpname.c_str() );
+    return -1;
+  }
+  return 0;
+}
+
+// Binary values that are larger than Fl_Preferences::binary_threshold() are
+// kept in a file next to the preferences file. The entry in the preferences
+// file refers to the value with "@blob:<id>:<size>". The binary file starts
+// with a header line, followed by one record per value: the id and the size
+// as 32 bit little endian numbers, and the data. The file is read when the
+// first value is needed. When new values were added, it is rewritten with the
+// new values and all old values before the preferences file is written, since
+// the old preferences file may still refer to them. After the preferences
+// file was written, values that are no longer used are dropped, and the file
+// is removed when no value refers to it.
+static const char blobHeader[] = "; FLTK binary preferences 1.0\n";
+
+class Fl_Preferences::RootNode::Blob_Store {
+  static unsigned get32( const char *p ) {
+    const unsigned char *u = (const unsigned char*)p;
+    return u[0] | (u[1]<<8) | (u[2]<<16) | ((unsigned)u[3]<<24);
+  }
+  static void put32( std::vector<char> &d, unsigned v ) {
+    for ( int i = 0; i < 4; i++, v >>= 8 ) d.push_back( (char)(v & 0xff) );
+  }
+  static void collect( Node *nd, std::vector<unsigned> &ids ) {
+    for ( int i = 0; i < nd->nEntry(); i++ ) {
+      const char *v = nd->entry(i).value;
+      unsigned id;
+      int size;
+      if ( v && parseBinaryRef( v, id, size ) )
+        ids.push_back( id );
+    }
+    for ( int i = 0; i < nd->nChildren(); i++ )
+      collect( nd->childNode(i), ids );
+  }
+  void index() {
+    offsets.clear();
+    size_t hl = sizeof(blobHeader) - 1;
+    if ( data.size() < hl || memcmp( &data[0], blobHeader, hl ) != 0 )
+      return;
+    for ( size_t p = hl; p + 8 <= data.size(); ) {
+      unsigned id = get32( &data[p] ), n = get32( &data[p+4] );
+      p += 8;
+      if ( n > data.size() - p ) break;     // truncated file
+      offsets[id] = std::make_pair( p, (int)n );
+      if ( id > lastId ) lastId = id;
+      p += n;
+    }
+  }
+public:
+  std::string filename;
+  std::vector<char> data;                               // contents of the binary file
+  std::map<unsigned, std::pair<size_t, int> > offsets;  // id -> offset in data, size
+  std::map<unsigned, std::vector<char> > added;         // values set since the last write
+  unsigned lastId;
+
+  // the name of the binary file next to the preferences file
+  static std::string binaryFilename( const char *prefs_filename ) {
+    std::string name = prefs_filename;
+    size_t ext = name.rfind( ".prefs" );
+    if ( ext != std::string::npos && ext + 6 == name.size() )
+      name.erase( ext );
+    return name + ".blobs";
+  }
+
+  // remove the binary file of preferences that referred to it when they were
+  // read, if no entry refers to it anymore
+  static char removeUnused( const char *prefs_filename, Node *root ) {
+    std::vector<unsigned> ids;
+    collect( root, ids );
+    if ( !ids.empty() )
+      return 0;
+    fl_unlink( binaryFilename( prefs_filename ).c_str() );
+    return 1;
+  }
+
+  Blob_Store( const char *prefs_filename ) : lastId(0) {
+    filename = binaryFilename( prefs_filename );
+    FILE *f = fl_fopen( filename.c_str(), "rb" );
+    if ( f ) {
+      readFile( f, data );
+      fclose( f );
+      index();
+    }
+  }
+
+  const char *find( unsigned id, int size ) {
+    std::map<unsigned, std::vector<char> >::iterator a = added.find( id );
+    if ( a != added.end() )
+      return (int)a->second.size() == size ? ( size ? &a->second[0] : "" ) : 0;
+    std::map<unsigned, std::pair<size_t, int> >::iterator o = offsets.find( id );
+    if ( o != offsets.end() && o->second.second == size )
+      return size ? &data[o->second.first] : "";
+    return 0;
+  }
+
+  // write the values that were added and are referenced by the preferences,
+  // and keep all values of the file, before the preferences file is written
+  int write( Node *root ) {
+    if ( added.empty() ) return 0;
+    std::vector<unsigned> ids;
+    collect( root, ids );
+    std::vector<unsigned> keep;
+    std::map<unsigned, std::pair<size_t, int> >::iterator o;
+    for ( o = offsets.begin(); o != offsets.end(); ++o )
+      keep.push_back( o->first );
+    for ( size_t i = 0; i < ids.size(); i++ )
+      if ( added.count( ids[i] ) && !offsets.count( ids[i] ) )
+        keep.push_back( ids[i] );
+    if ( keep.size() == offsets.size() ) {  // no new value is referenced
+      added.clear();
+      return 0;
+    }
+    return save( keep );
+  }
+
+  // drop the values that are no longer referenced after the preferences
+  // file was written, and remove the file if no value is left
+  void compact( Node *root ) {
+    if ( data.empty() )
+      return;                   // no file was read or written
+    std::vector<unsigned> ids;
+    collect( root, ids );
+    if ( ids.empty() ) {
+      fl_unlink( filename.c_str() );
+      data.clear();
+      offsets.clear();
+      return;
+    }
+    std::vector<unsigned> keep;
+    for ( size_t i = 0; i < ids.size(); i++ )
+      if ( offsets.count( ids[i] ) )
+        keep.push_back( ids[i] );
+    if ( keep.size() < offsets.size() )
+      save( keep );             // the values are still complete if this fails
+  }
+
+  // write the values with the given ids to the binary file
+  int save( const std::vector<unsigned> &ids ) {
+    std::vector<char> image( blobHeader, blobHeader + sizeof(blobHeader) - 1 );
+    for ( size_t i = 0; i < ids.size(); i++ ) {
+      std::map<unsigned, std::vector<char> >::iterator a = added.find( ids[i] );
+      std::map<unsigned, std::pair<size_t, int> >::iterator o = offsets.find( ids[i] );
+      const char *src;
+      size_t n;
+      if ( a != added.end() ) {
+        src = a->second.empty() ? "" : &a->second[0];
+        n = a->second.size();
+      } else if ( o != offsets.end() ) {
+        src = &data[o->second.first];
+        n = o->second.second;
+      } else {
+        continue;               // the binary file was damaged
+      }
+      put32( image, ids[i] );
+      put32( image, (unsigned)n );
+      image.insert( image.end(), src, src + n );
+    }
+    std::string tmpname = filename + ".tmp";
+    FILE *f = fl_fopen( tmpname.c_str(), "wb" );
+    if ( !f )
+      return -1;
+    fwrite( &image[0], image.size(), 1, f );
+    if ( writeFileAtomic( filename.c_str(), tmpname, f ) < 0 )
+      return -1;
+    data.swap( image );
+    added.clear();
+    index();
+    return 0;
+  }
+};
+
 // create the root node
 // - construct the name of the file that will hold our preferences
 Fl_Preferences::RootNode::RootNode( Fl_Preferences *prefs, Root root, const char *vendor, const char *application )
@@ -1336,7 +1646,9 @@ Fl_Preferences::RootNode::RootNode( Fl_Preferences *prefs, Root root, const char
   filename_(0L),
   vendor_(0L),
   application_(0L),
-  root_type_((Root)(root & ~CLEAR))
+  root_type_((Root)(root & ~CLEAR)),
+  blobs_(0L),
+  blobRefs_(0)
 {
   char *filename = Fl::system_driver()->preference_rootnode(prefs, root, vendor, application);
   filename_    = filename ? fl_strdup(filename) : 0L;
@@ -1353,7 +1665,9 @@ Fl_Preferences::RootNode::RootNode( Fl_Preferences *prefs, const char *path, con
   filename_(0L),
   vendor_(0L),
   application_(0L),
-  root_type_( (Root)(USER | (flags & C_LOCALE) ))
+  root_type_( (Root)(USER | (flags & C_LOCALE) )),
+  blobs_(0L),
+  blobRefs_(0)
 {
 
   if (!vendor)
@@ -1379,7 +1693,9 @@ Fl_Preferences::RootNode::RootNode( Fl_Preferences *prefs )
   filename_(0L),
   vendor_(0L),
   application_(0L),
-  root_type_(Fl_Preferences::MEMORY)
+  root_type_(Fl_Preferences::MEMORY),
+  blobs_(0L),
+  blobRefs_(0)
 {
 }
 
@@ -1387,6 +1703,7 @@ Fl_Preferences::RootNode::RootNode( Fl_Preferences *prefs )
 Fl_Preferences::RootNode::~RootNode() {
   if ( prefs_->node->dirty() )
     write();
+  delete blobs_;
   if ( filename_ ) {
     free( filename_ );
     filename_ = 0L;
@@ -1423,35 +1740,46 @@ int Fl_Preferences::RootNode::read() {
     prefs_->node->clearDirtyFlags();
     return -1;
   }
-  char buf[1024];
   FILE *f = fl_fopen( filename_, "rb" );
   if ( !f )
     return -1;
-  if (fgets( buf, 1024, f )==0) { /* ignore: "; FLTK preferences file format 1.0" */ }
-  if (fgets( buf, 1024, f )==0) { /* ignore: "; vendor: ..." */ }
-  if (fgets( buf, 1024, f )==0) { /* ignore: "; application: ..." */ }
+  // read the entire file at once and split it into lines in place
+  std::vector<char> data;
+  readFile( f, data );
+  fclose( f );
+  data.push_back( 0 );
+  char *buf = &data[0], *end = buf + data.size() - 1;
+  int skip = 3;                                 // ignore: "; FLTK preferences file format 1.0"
+                                                //         "; vendor: ...", "; application: ..."
   Node *nd = prefs_->node;
-  for (;;) {
-    if ( !fgets( buf, 1024, f ) ) break;        // EOF or Error
+  for ( char *nl; buf < end; buf = nl+1 ) {
+    nl = (char*)memchr( buf, '\n', end-buf );
+    if ( !nl ) nl = end;
+    *nl = 0;
+    if ( skip > 0 ) {
+      skip--;
+      continue;
+    }
     if ( buf[0]=='[' ) {                        // read a new group
-      size_t end = strcspn( buf+1, "]\n\r" );
-      buf[ end+1 ] = 0;
+      size_t len = strcspn( buf+1, "]\r" );
+      buf[ len+1 ] = 0;
       nd = prefs_->node->find( buf+1 );
     } else if ( buf[0]=='+' ) {                 // value of previous name/value pair spans multiple lines
-      size_t end = strcspn( buf+1, "\n\r" );
-      if ( end != 0 ) {                         // if entry is not empty
-        buf[ end+1 ] = 0;
+      size_t len = strcspn( buf+1, "\r" );
+      if ( len != 0 ) {                         // if entry is not empty
+        buf[ len+1 ] = 0;
         if (nd) nd->add( buf+1 );
       }
     } else {                                     // read a name/value pair
-      size_t end = strcspn( buf, "\n\r" );
-      if ( end != 0 ) {                         // if entry is not empty
-        buf[ end ] = 0;
+      size_t len = strcspn( buf, "\r" );
+      if ( len != 0 ) {                         // if entry is not empty
+        buf[ len ] = 0;
         if (nd) nd->set( buf );
+        if ( strstr( buf, ":@blob:" ) )
+          blobRefs_ = 1;
       }
     }
   }
-  fclose( f );
   prefs_->node->clearDirtyFlags();
   return 0;
 }
@@ -1471,14 +1799,27 @@ int Fl_Preferences::RootNode::write() {
   if ( ((root_type_&Fl_Preferences::ROOT_MASK)==Fl_Preferences::SYSTEM) && !(fileAccess_ & Fl_Preferences::SYSTEM_WRITE_OK) )
     return -1;
   fl_make_path_for_file(filename_);
-  FILE *f = fl_fopen( filename_, "wb" );
+  // the binary file must be complete before the preferences refer to it
+  if ( blobs_ && blobs_->write( prefs_->node ) < 0 )
+    return -1;
+  // Write to a temporary file and rename it when it is complete, so the
+  // preferences file is never left half written if the application or
+  // the system fails while writing.
+  std::string tmpname = std::string(filename_) + ".tmp";
+  FILE *f = fl_fopen( tmpname.c_str(), "wb" );
   if ( !f )
     return -1;
   fprintf( f, "; FLTK preferences file format 1.0\n" );
   fprintf( f, "; vendor: %s\n", vendor_ );
   fprintf( f, "; application: %s\n", application_ );
   prefs_->node->write( f );
-  fclose( f );
+  if ( writeFileAtomic( filename_, tmpname, f ) < 0 )
+    return -1;                  // the nodes stay dirty, flush() will try again
+  prefs_->node->clearDirtyFlags();
+  if ( blobs_ )
+    blobs_->compact( prefs_->node );
+  else if ( blobRefs_ && Blob_Store::removeUnused( filename_, prefs_->node ) )
+    blobRefs_ = 0;
   if (Fl::system_driver()->preferences_need_protection_check()) {
     // unix: make sure that system prefs are user-readable
     if (strncmp(filename_, "/etc/fltk/", 10) == 0) {
@@ -1496,6 +1837,34 @@ int Fl_Preferences::RootNode::write() {
   return 0;
 }
 
+// create the binary value store when it is first needed
+Fl_Preferences::RootNode::Blob_Store *Fl_Preferences::RootNode::blobs() {
+  if ( !blobs_ )
+    blobs_ = new Blob_Store( filename_ );
+  return blobs_;
+}
+
+// get the data of a binary value that is referenced by an entry
+// - returns NULL if the reference is invalid or the binary file is missing
+const char *Fl_Preferences::RootNode::getBinary( const char *ref, int &size ) {
+  unsigned id;
+  if ( !filename_ || !parseBinaryRef( ref, id, size ) )
+    return 0;
+  return blobs()->find( id, size );
+}
+
+// store a binary value in the binary file and create the reference to it
+// - returns 0 if the preferences have no file that the value can be stored next to
+char Fl_Preferences::RootNode::setBinary( const void *data, int size, char *ref, int reflen ) {
+  if ( !filename_ || !filename_[0] || (root_type_&Fl_Preferences::ROOT_MASK)==Fl_Preferences::MEMORY )
+    return 0;
+  Blob_Store *b = blobs();
+  unsigned id = ++b->lastId;
+  b->added[id].assign( (const char*)data, (const char*)data + size );
+  snprintf( ref, reflen, "@blob:%u:%d", id, size );
+  return 1;
+}
+
 // get the path to the preferences directory
 // - copy the path into the buffer at "path"
 // - if the resulting path is longer than "pathlen", it will be cropped
@@ -1547,6 +1916,30 @@ char Fl_Preferences::RootNode::getPath( char *path, int pathlen ) {
   return ret;
 }
 
+// Nodes with many entries or children keep hash tables of their names, so
+// looking up an entry or a group does not compare the name with all of them.
+// The keys point to the entry names and to the node paths, which stay valid
+// as long as the entry or child is in the table.
+static const int kLookupMin = 16;
+
+class Fl_Preferences::Node::Lookup {
+  struct Hash {
+    size_t operator()( const char *s ) const {
+      size_t h = 2166136261u;   // FNV-1a
+      for ( ; *s; s++ ) h = ( h ^ (unsigned char)*s ) * 16777619u;
+      return h;
+    }
+  };
+  struct Equal {
+    bool operator()( const char *a, const char *b ) const { return strcmp( a, b ) == 0; }
+  };
+public:
+  std::unordered_map<const char*, int, Hash, Equal> entries;    // name -> index in entry_
+  std::unordered_map<const char*, Node*, Hash, Equal> children; // name -> child node
+  bool has_entries, has_children;
+  Lookup() : has_entries(false), has_children(false) { }
+};
+
 // create a node that represents a group
 // - path must be a single word, preferable alnum(), dot and underscore only. Space is ok.
 Fl_Preferences::Node::Node( const char *path ) {
@@ -1559,6 +1952,7 @@ Fl_Preferences::Node::Node( const char *path ) {
   indexed_ = 0;
   index_ = 0;
   nIndex_ = NIndex_ = 0;
+  lookup_ = 0;
 }
 
 void Fl_Preferences::Node::deleteAllChildren() {
@@ -1568,6 +1962,10 @@ void Fl_Preferences::Node::deleteAllChildren() {
     delete current_node;
   }
   first_child_ = NULL;
+  if ( lookup_ ) {
+    lookup_->children.clear();
+    lookup_->has_children = false;
+  }
   dirty_ = 1;
   updateIndex();
 }
@@ -1589,6 +1987,10 @@ void Fl_Preferences::Node::deleteAllEntries() {
     nEntry_ = 0;
     NEntry_ = 0;
   }
+  if ( lookup_ ) {
+    lookup_->entries.clear();
+    lookup_->has_entries = false;
+  }
   dirty_ = 1;
 }
 
@@ -1599,6 +2001,7 @@ Fl_Preferences::Node::~Node() {
   deleteAllChildren();
   deleteAllEntries();
   deleteIndex();
+  delete lookup_;
   if ( path_ ) {
     ::free( path_ );
     path_ = NULL;
@@ -1607,9 +2010,10 @@ Fl_Preferences::Node::~Node() {
 
 // recursively check if any entry is dirty (was changed after loading a fresh prefs file)
 char Fl_Preferences::Node::dirty() {
-  if ( dirty_ ) return 1;
-  if ( next_ && next_->dirty() ) return 1;
-  if ( first_child_ && first_child_->dirty() ) return 1;
+  for ( Node *nd = this; nd; nd = nd->next_ ) {
+    if ( nd->dirty_ ) return 1;
+    if ( nd->first_child_ && nd->first_child_->dirty() ) return 1;
+  }
   return 0;
 }
 
@@ -1623,11 +2027,23 @@ void Fl_Preferences::Node::clearDirtyFlags() {
   }
 }
 
-// write this node (recursively from the last neighbor back to this)
+// write this node and its neighbors (from the last neighbor back to this)
 // write all entries
 // write all children
 int Fl_Preferences::Node::write( FILE *f ) {
-  if ( next_ ) next_->write( f );
+  if ( next_ ) {
+    // a group can have thousands of neighbors, don't recurse over them
+    std::vector<Node*> nodes;
+    for ( Node *nd = next_; nd; nd = nd->next_ )
+      nodes.push_back( nd );
+    for ( size_t k = nodes.size(); k > 0; k-- ) {
+      Node *nd = nodes[k-1];
+      Node *next = nd->next_;
+      nd->next_ = NULL;
+      nd->write( f );
+      nd->next_ = next;
+    }
+  }
   fprintf( f, "\n[%s]\n\n", path_ );
   for ( int i = 0; i < nEntry_; i++ ) {
     char *src = entry_[i].value;
@@ -1653,7 +2069,6 @@ int Fl_Preferences::Node::write( FILE *f ) {
       fprintf( f, "%s\n", entry_[i].name );
   }
   if ( first_child_ ) first_child_->write( f );
-  dirty_ = 0;
   return 0;
 }
 
@@ -1665,6 +2080,8 @@ void Fl_Preferences::Node::setParent( Node *pn ) {
   snprintf( nameBuffer, sizeof(nameBuffer), "%s/%s", pn->path_, path_ );
   free( path_ );
   path_ = fl_strdup( nameBuffer );
+  if ( pn->lookup_ && pn->lookup_->has_children )
+    pn->lookup_->children[ name() ] = this;
 }
 
 // find the corresponding root node
@@ -1691,18 +2108,17 @@ Fl_Preferences::Node *Fl_Preferences::Node::addChild( const char *path ) {
 // create and set, or change an entry within this node
 void Fl_Preferences::Node::set( const char *name, const char *value )
 {
-  for ( int i=0; i<nEntry_; i++ ) {
-    if ( strcmp( name, entry_[i].name ) == 0 ) {
-      if ( !value ) return; // annotation
-      if ( strcmp( value, entry_[i].value ) != 0 ) {
-        if ( entry_[i].value )
-          free( entry_[i].value );
-        entry_[i].value = fl_strdup( value );
-        dirty_ = 1;
-      }
-      lastEntrySet = i;
-      return;
+  int i = getEntry( name );
+  if ( i >= 0 ) {
+    if ( !value ) return; // annotation
+    if ( !entry_[i].value || strcmp( value, entry_[i].value ) != 0 ) {
+      if ( entry_[i].value )
+        free( entry_[i].value );
+      entry_[i].value = fl_strdup( value );
+      dirty_ = 1;
     }
+    lastEntrySet = i;
+    return;
   }
   if ( NEntry_==nEntry_ ) {
     NEntry_ = NEntry_ ? NEntry_*2 : 10;
@@ -1710,6 +2126,8 @@ void Fl_Preferences::Node::set( const char *name, const char *value )
   }
   entry_[ nEntry_ ].name = fl_strdup( name );
   entry_[ nEntry_ ].value = value?fl_strdup(value):0;
+  if ( lookup_ && lookup_->has_entries )
+    lookup_->entries[ entry_[ nEntry_ ].name ] = nEntry_;
   lastEntrySet = nEntry_;
   nEntry_++;
   dirty_ = 1;
@@ -1756,18 +2174,36 @@ const char *Fl_Preferences::Node::get( const char *name ) {
 
 // find the index of an entry, returns -1 if no such entry
 int Fl_Preferences::Node::getEntry( const char *name ) {
-  for ( int i=0; i<nEntry_; i++ ) {
-    if ( strcmp( name, entry_[i].name ) == 0 ) {
-      return i;
+  if ( nEntry_ < kLookupMin ) {
+    for ( int i=0; i<nEntry_; i++ ) {
+      if ( strcmp( name, entry_[i].name ) == 0 ) {
+        return i;
+      }
     }
+    return -1;
   }
-  return -1;
+  if ( !lookup_ ) lookup_ = new Lookup;
+  if ( !lookup_->has_entries ) {
+    // insert in reverse order, so the first of duplicate names is found
+    for ( int i=nEntry_-1; i>=0; i-- )
+      lookup_->entries[ entry_[i].name ] = i;
+    lookup_->has_entries = true;
+  }
+  auto it = lookup_->entries.find( name );
+  return it != lookup_->entries.end() ? it->second : -1;
 }
 
 // remove one entry form this group
 char Fl_Preferences::Node::deleteEntry( const char *name ) {
   int ix = getEntry( name );
   if ( ix == -1 ) return 0;
+  if ( lookup_ && lookup_->has_entries ) {
+    lookup_->entries.erase( entry_[ix].name );
+    for ( int i = ix+1; i < nEntry_; i++ )
+      lookup_->entries[ entry_[i].name ] = i-1;
+  }
+  free( entry_[ix].name );
+  free( entry_[ix].value );
   memmove( entry_+ix, entry_+ix+1, (nEntry_-ix-1) * sizeof(Entry) );
   nEntry_--;
   dirty_ = 1;
@@ -1779,26 +2215,53 @@ char Fl_Preferences::Node::deleteEntry( const char *name ) {
 // - if the node was not found, 'find' will create the required branch
 Fl_Preferences::Node *Fl_Preferences::Node::find( const char *path ) {
   int len = (int) strlen( path_ );
-  if ( strncmp( path, path_, len ) == 0 ) {
-    if ( path[ len ] == 0 )
-      return this;
-    if ( path[ len ] == '/' ) {
-      Node *nd;
-      for ( nd = first_child_; nd; nd = nd->next_ ) {
-        Node *nn = nd->find( path );
-        if ( nn ) return nn;
-      }
-      const char *s = path+len+1;
-      const char *e = strchr( s, '/' );
+  if ( strncmp( path, path_, len ) != 0 )
+    return 0;
+  if ( path[ len ] == 0 )
+    return this;
+  if ( path[ len ] != '/' )
+    return 0;
+  // walk down the tree, one path component at a time
+  Node *nd = this;
+  const char *s = path+len+1;
+  for (;;) {
+    const char *e = strchr( s, '/' );
+    size_t n = e ? (size_t)(e-s) : strlen( s );
+    Node *nn = nd->findChild( s, n );
+    if ( !nn ) {
       if (e) strlcpy( nameBuffer, s, e-s+1 );
       else strlcpy( nameBuffer, s, sizeof(nameBuffer));
-      nd = new Node( nameBuffer );
-      nd->setParent( this );
-      dirty_ = 1;
-      return nd->find( path );
+      nn = new Node( nameBuffer );
+      nn->setParent( nd );
+      nd->dirty_ = 1;
     }
+    nd = nn;
+    if ( !e ) return nd;
+    s = e+1;
   }
-  return 0;
+}
+
+// find the direct child with the given name, returns 0 if there is none
+// - name is not nul-terminated, len is its length
+Fl_Preferences::Node *Fl_Preferences::Node::findChild( const char *name, size_t len ) {
+  if ( !lookup_ || !lookup_->has_children ) {
+    int cnt = 0;
+    for ( Node *nd = first_child_; nd; nd = nd->next_, cnt++ ) {
+      const char *nm = nd->name();
+      if ( strncmp( nm, name, len ) == 0 && nm[len] == 0 )
+        return nd;
+    }
+    if ( cnt < kLookupMin )
+      return 0;
+    if ( !lookup_ ) lookup_ = new Lookup;
+    for ( Node *nd = first_child_; nd; nd = nd->next_ )
+      lookup_->children.insert( std::make_pair( (const char*)nd->name(), nd ) );
+    lookup_->has_children = true;
+    return 0;
+  }
+  std::string key( name, len );
+  auto it = lookup_->children.find( key.c_str() );
+  return it != lookup_->children.end() ? it->second : 0;
 }
 
 // find a group somewhere in the tree starting here
@@ -1903,6 +2366,11 @@ char Fl_Preferences::Node::remove() {
         else
           parent_node->first_child_ = next_;
         next_ = NULL;
+        if ( parent_node->lookup_ && parent_node->lookup_->has_children ) {
+          // another child of the same name may have been hidden by this one
+          parent_node->lookup_->children.clear();
+          parent_node->lookup_->has_children = false;
+        }
         break;
       }
     }
@@ -169,8 +169,12 @@ void Fl_Scroll::draw_clip(void* v,int X, int Y, int W, int H) {
 
   // draw visible children
   Fl_Widget*const* a = s->array();
-  for (int i=s->children()-2; i--;) {
+  int n = s->children();
+  std::vector<Fl_Widget*> list;
+  s->children_in(X, Y, W, H, a, n, list);
+  for (int i=n; i--;) {
     Fl_Widget& o = **a++;
+    if (&o == &s->scrollbar || &o == &s->hscrollbar) continue;
     s->draw_child(o);
     s->draw_outside_label(o);
   }
@@ -460,11 +464,7 @@ void Fl_Scroll::resize(int X, int Y, int W, int H) {
   Fl_Widget::resize(X,Y,W,H); // resize _before_ moving children around
   fix_scrollbar_order();
   // move all the children:
-  Fl_Widget*const* a = array();
-  for (int i=children()-2; i--;) {
-    Fl_Widget* o = *a++;
-    o->position(o->x()+dx, o->y()+dy);
-  }
+  move_children(dx, dy, children()-2);
   if (dw==0 && dh==0) {
     char pad = ( scrollbar.visible() && hscrollbar.visible() );
     char al = ( (scrollbar.align() & FL_ALIGN_LEFT) != 0 );
@@ -499,12 +499,8 @@ void Fl_Scroll::scroll_to(int X, int Y) {
   if (!dx && !dy) return;
   xposition_ = X;
   yposition_ = Y;
-  Fl_Widget*const* a = array();
-  for (int i=children(); i--;) {
-    Fl_Widget* o = *a++;
-    if (o == &hscrollbar || o == &scrollbar) continue;
-    o->position(o->x()+dx, o->y()+dy);
-  }
+  fix_scrollbar_order();
+  move_children(dx, dy, children()-2); // all but the scrollbars
   if (parent() == (Fl_Group *)window() && Fl::scheme_bg_) damage(FL_DAMAGE_ALL);
   else damage(FL_DAMAGE_SCROLL);
 }
@@ -38,6 +38,11 @@ Fl_Shared_Handler *Fl_Shared_Image::handlers_ = 0;// Additional format handlers
 int     Fl_Shared_Image::num_handlers_ = 0;     // Number of format handlers
 int     Fl_Shared_Image::alloc_handlers_ = 0;   // Allocated format handlers
 
+// Size requested by get() while an image is loaded, see requested_size().
+// Images are also loaded by the threads of get_async().
+static thread_local int requested_w = 0;
+static thread_local int requested_h = 0;
+
 
 //
 // Typedef the C API sort function type the only way I know how...
@@ -232,7 +237,7 @@ void Fl_Shared_Image::release() {
 
   // If this image is not the original, find the original image and make sure
   // to delete its reference counter as well at the end of this method.
-  if (!original()) {
+  if (!original_) {
     Fl_Shared_Image *o = find(name());
     if (o) {
       if (o->original() && o!=this && o->refcount_>1)
@@ -275,49 +280,61 @@ void Fl_Shared_Image::release() {
 
 /** Reloads the shared image from disk. */
 void Fl_Shared_Image::reload() {
-  // Load image from disk...
+  if (!name_) return;
+
+  Fl_Image *img = load_(name_);
+  if (img) {
+    if (alloc_image_) delete image_;
+
+    alloc_image_ = 1;
+    image_ = img;
+    int W = w();
+    int H = h();
+    update();
+    // Make sure the reloaded image gets the same drawing size as the existing one.
+    if (W)
+      scale(W, H, 0, 1);
+  }
+}
+
+/*
+ Loads an image file with the image handlers, or returns NULL.
+
+ If W and H are not 0, handlers can load a large image at a reduced size,
+ see requested_size(). This is called by threads of get_async() as well.
+ */
+Fl_Image *Fl_Shared_Image::load_(const char *name, int W, int H) {
   int           i;              // Looping var
   int           count = 0;      // number of bytes read from image header
   FILE          *fp;            // File pointer
   uchar         header[64];     // Buffer for auto-detecting files
   Fl_Image      *img;           // New image
 
-  if (!name_) return;
-
-  if ((fp = fl_fopen(name_, "rb")) != NULL) {
+  if ((fp = fl_fopen(name, "rb")) != NULL) {
     count = (int)fread(header, 1, sizeof(header), fp);
     fclose(fp);
     if (count == 0)
-      return;
+      return NULL;
   } else {
-    return;
+    return NULL;
   }
 
   // Load the image as appropriate...
   if (count >= 7 && memcmp(header, "#define", 7) == 0) // XBM file
-    img = new Fl_XBM_Image(name_);
+    img = new Fl_XBM_Image(name);
   else if (count >= 9 && memcmp(header, "/* XPM */", 9) == 0) // XPM file
-    img = new Fl_XPM_Image(name_);
+    img = new Fl_XPM_Image(name);
   else {
     // Not a standard format; try an image handler...
+    requested_w = W;
+    requested_h = H;
     for (i = 0, img = 0; i < num_handlers_; i ++) {
-      img = (handlers_[i])(name_, header, count);
+      img = (handlers_[i])(name, header, count);
       if (img) break;
     }
+    requested_w = requested_h = 0;
   }
-
-  if (img) {
-    if (alloc_image_) delete image_;
-
-    alloc_image_ = 1;
-    image_ = img;
-    int W = w();
-    int H = h();
-    update();
-    // Make sure the reloaded image gets the same drawing size as the existing one.
-    if (W)
-      scale(W, H, 0, 1);
-  }
+  return img;
 }
 
 /**
@@ -333,21 +350,22 @@ void Fl_Shared_Image::reload() {
  */
 Fl_Shared_Image *
 Fl_Shared_Image::copy_(int W, int H) const {
-  Fl_Image              *temp_image;    // New image file
-  Fl_Shared_Image       *temp_shared;   // New shared image
-
   // Make a copy of the image we're sharing...
-  if (!image_) temp_image = 0;
-  else temp_image = image_->copy(W, H);
+  return wrap_(name_, image_ ? image_->copy(W, H) : 0);
+}
 
-  // Then make a new shared image...
-  temp_shared = new Fl_Shared_Image();
+/*
+ Makes a new shared image with the given name that is not an original
+ image and that is not yet in the pool. The shared image owns img.
+ */
+Fl_Shared_Image *Fl_Shared_Image::wrap_(const char *name, Fl_Image *img) {
+  Fl_Shared_Image *temp_shared = new Fl_Shared_Image();
 
-  temp_shared->name_ = new char[strlen(name_) + 1];
-  strcpy((char *)temp_shared->name_, name_);
+  temp_shared->name_ = new char[strlen(name) + 1];
+  strcpy((char *)temp_shared->name_, name);
 
   temp_shared->refcount_    = 1;
-  temp_shared->image_       = temp_image;
+  temp_shared->image_       = img;
   temp_shared->alloc_image_ = 1;
 
   temp_shared->update();
@@ -529,7 +547,7 @@ Fl_Shared_Image* Fl_Shared_Image::find(const char *name, int W, int H) {
         // search back and forth from that location for the member with the
         // original_ flag set.
         Fl_Shared_Image *img = images_[i];
-        if (img->original_ && img->name_ && (strcmp(img->name_, name) == 0)) {
+        if (img->original_ == 1 && img->name_ && (strcmp(img->name_, name) == 0)) {
           img->refcount_++;
           return img;
         }
@@ -561,6 +579,13 @@ Fl_Shared_Image* Fl_Shared_Image::find(const char *name, int W, int H) {
         If you request the same image with another size later, then the
         \b original image will be found, copied, resized, and returned.
 
+  \note If the original image is not yet loaded, image handlers can decode
+        a large image directly at a reduced size for the requested size,
+        see requested_size(). Only the resized image is then added to the
+        list of shared images, and the original image will be loaded when
+        it is requested. This makes loading thumbnails of large JPEG images
+        much faster.
+
   Shared JPEG and PNG images can also be created from memory by using their
   named memory access constructor.
 
@@ -578,7 +603,6 @@ Fl_Shared_Image* Fl_Shared_Image::find(const char *name, int W, int H) {
 */
 Fl_Shared_Image* Fl_Shared_Image::get(const char *name, int W, int H) {
   Fl_Shared_Image *temp;
-  bool temp_referenced = false;
 
   // Find an image by the requested size
   // ::find() increments the ref count for us
@@ -587,37 +611,90 @@ Fl_Shared_Image* Fl_Shared_Image::get(const char *name, int W, int H) {
 
   // Find the original image, size does not matter
   temp = find(name);
-  if (temp) {
-    temp_referenced = true;
-  } else {
-    // No original found, so we generate it by loading the file
-    temp = new Fl_Shared_Image(name);
+  if (!temp) {
+    // No original found, so we generate it by loading the file. Image
+    // handlers can decode the image at a reduced size close to W x H.
+    Fl_Image *img = load_(name, W, H);
     // We can't load the file or create the image, so return fail
-    if (!temp->image_) {
-      delete temp;
+    if (!img)
       return NULL;
-    }
-    // Add the new image to the pool, refcount is already at 1
-    temp->add();
+    return add_loaded_(name, W, H, img, NULL);
   }
 
   // At this point, temp is an original image
   // But if the size is wrong, generate a resized copy
   if ((temp->w() != W || temp->h() != H) && W && H) {
     // Generate a copy with the new size, the copy gets refcount 1
+    // and keeps the reference to the original made by find()
     Fl_Shared_Image *new_temp = temp->copy_(W, H);
     if (!new_temp) return NULL;
+    // add the newly created image to the pool and return it
+    new_temp->add();
+    return new_temp;
+  }
+
+  return temp;
+}
+
+/*
+ Adds the image img that was just loaded from file name to the pool, as
+ well as its copy with size W x H, if the size differs. The copy can be
+ given as sized, otherwise it is made here. Returns the image with size
+ W x H, or the original image if W or H is 0.
+
+ The caller must make sure that the original image is not yet in the pool.
+ */
+Fl_Shared_Image *Fl_Shared_Image::add_loaded_(const char *name, int W, int H,
+                                              Fl_Image *img, Fl_Image *sized) {
+  if (W && H && img->data_w() < img->w()) {
+    // The image was loaded at a reduced size. It must not be used as
+    // the original, so only its copy with the requested size is added
+    // to the pool. It does not reference an original image.
+    Fl_Shared_Image *temp = wrap_(name, sized ? sized : img->copy(W, H));
+    delete img;
+    temp->original_ = 2;
+    temp->add();
+    return temp;
+  }
+
+  // Add the new original image to the pool, refcount is already at 1
+  Fl_Shared_Image *temp = new Fl_Shared_Image(name, img);
+  temp->alloc_image_ = 1;
+  temp->add();
+
+  if (W && H && (temp->w() != W || temp->h() != H)) {
+    // Generate a copy with the new size, the copy gets refcount 1
+    Fl_Shared_Image *new_temp = sized ? wrap_(name, sized) : temp->copy_(W, H);
     // Also increment the refcount of the original image
-    if (!temp_referenced)
-      temp->refcount_++;
+    temp->refcount_++;
     // add the newly created image to the pool and return it
     new_temp->add();
     return new_temp;
   }
 
+  delete sized;
   return temp;
 }
 
+/**
+  Returns the image size requested with get(const char *, int, int) while
+  it loads an image.
+
+  Image handlers (see add_handler()) can call this to decode large images
+  directly at a reduced size that is at least \p W x \p H pixels, as the
+  JPEG image handler does. Such an image must be returned with its full
+  size as its drawing size, i.e. w() and h() must be larger than data_w()
+  and data_h() as if Fl_Image::scale() had been called.
+
+  \param[out] W, H requested size, or 0 if the full image is loaded
+  \see Fl_JPEG_Image::Fl_JPEG_Image(const char *filename, int W, int H)
+  \since 1.5.0
+*/
+void Fl_Shared_Image::requested_size(int &W, int &H) {
+  W = requested_w;
+  H = requested_h;
+}
+
 /** Builds a shared image from a pre-existing Fl_RGB_Image.
 
  \param[in] rgb         an Fl_RGB_Image used to build a new shared image.
@@ -708,7 +785,7 @@ void Fl_Shared_Image::print_pool() {
     printf("%3d: %3d(%c) %4dx%4d: %s\n",
            i,
            img->refcount_,
-           img->original_ ? 'O' : '_',
+           img->original_ ? (img->original_ == 1 ? 'O' : 'R') : '_',
            img->w(), img->h(),
            img->name()
            );
@@ -0,0 +1,321 @@
+//
+// Asynchronous loading of shared images for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// Fl_Shared_Image::get_async() loads image files with a small pool of
+// worker threads. The threads only run the image handlers and resize the
+// image, all changes of the shared image pool and all callbacks are done
+// by the main thread when it processes the Fl::awake() handler.
+
+#include <config.h>
+#include <FL/Fl.H>
+#include <FL/Fl_Shared_Image.H>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#if defined(HAVE_PTHREAD) || defined(_WIN32)
+#  define FL_ASYNC_IMAGES 1
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace {
+
+struct Waiter {
+  int id;
+  Fl_Shared_Image_Callback *cb;
+  void *data;
+};
+
+struct Job {
+  std::string name;
+  int W, H;
+  std::vector<Waiter> waiters;  // main thread only, empty if all were cancelled
+  bool started;                 // protected by the queue mutex
+  Fl_Image *image;              // the loaded image, set by the worker thread
+  Fl_Image *sized;              // its copy with size W x H, if needed
+};
+
+#if FL_ASYNC_IMAGES
+
+std::vector<Job*> jobs;         // all jobs not yet finished, main thread only
+int last_id = 0;
+
+// The pool is never deleted: the worker threads wait for jobs until
+// the program exits.
+struct Pool {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<Job*> queue;       // jobs not yet started
+  std::deque<Job*> done;        // finished jobs, processed by the main thread
+};
+
+Pool *pool = 0;
+
+// set in the worker threads, see Fl_Shared_Image::loading_async()
+thread_local bool async_thread = false;
+
+#endif // FL_ASYNC_IMAGES
+
+} // namespace
+
+
+#if FL_ASYNC_IMAGES
+
+/*
+ Loads the images of queued jobs, runs in the worker threads.
+ */
+void Fl_Shared_Image::async_worker_() {
+  async_thread = true;
+  for (;;) {
+    Job *job;
+    {
+      std::unique_lock<std::mutex> lock(pool->mutex);
+      pool->cond.wait(lock, [] { return !pool->queue.empty(); });
+      job = pool->queue.front();
+      pool->queue.pop_front();
+      job->started = true;
+    }
+    Fl_Image *img = load_(job->name.c_str(), job->W, job->H);
+    if (img && job->W && job->H &&
+        (img->data_w() != job->W || img->data_h() != job->H || img->data_w() < img->w()))
+      job->sized = img->copy(job->W, job->H);
+    job->image = img;
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      pool->done.push_back(job);
+    }
+    Fl::awake_once(async_done_, 0);
+  }
+}
+
+/*
+ Adds the images of finished jobs to the pool and calls the callbacks.
+ This is an Fl::awake() handler that runs in the main thread.
+ */
+void Fl_Shared_Image::async_done_(void *) {
+  for (;;) {
+    Job *job;
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      if (pool->done.empty()) return;
+      job = pool->done.front();
+      pool->done.pop_front();
+    }
+    for (size_t i = 0; i < jobs.size(); i++) {
+      if (jobs[i] == job) {
+        jobs.erase(jobs.begin() + i);
+        break;
+      }
+    }
+    const char *name = job->name.c_str();
+    int W = job->W, H = job->H;
+    Fl_Shared_Image *img = NULL;
+    if (job->image && !job->waiters.empty()) {
+      // get() may have loaded the image in the meantime
+      img = find(name, W, H);
+      if (!img) {
+        Fl_Shared_Image *orig = find(name);
+        if (!orig) {
+          img = add_loaded_(name, W, H, job->image, job->sized);
+          job->image = job->sized = NULL;
+        } else {
+          // the copy keeps the reference to the original made by find()
+          img = job->sized ? wrap_(name, job->sized) : orig->copy_(W, H);
+          job->sized = NULL;
+          img->add();
+        }
+      }
+    }
+    delete job->image;
+    delete job->sized;
+    // each callback gets its own reference to the image
+    std::vector<Waiter> waiters;
+    waiters.swap(job->waiters);
+    delete job;
+    for (size_t i = 0; i < waiters.size(); i++) {
+      if (img && i > 0) img->refcount_++;
+      waiters[i].cb(img, waiters[i].data);
+    }
+  }
+}
+
+#endif // FL_ASYNC_IMAGES
+
+
+/**
+  Returns whether the current thread loads an image for get_async().
+
+  Image handlers (see add_handler()) can call this to find out whether
+  they run in a worker thread of get_async(). They must not create
+  shared images, add timeouts, or call other functions that are reserved
+  for the main thread then. For instance, the GIF handler of the
+  fltk_images library does not animate GIF images in the worker threads.
+
+  \return true in a worker thread of get_async(), false otherwise
+  \see get_async()
+  \since 1.5.0
+*/
+bool Fl_Shared_Image::loading_async() {
+#if FL_ASYNC_IMAGES
+  return async_thread;
+#else
+  return false;
+#endif
+}
+
+
+/**
+  Loads an image in a background thread and calls a callback when it is loaded.
+
+  This does the same as get(const char *name, int W, int H), but the image
+  file is decoded, and resized if \p W and \p H are given, by one of a few
+  worker threads so the user interface stays responsive while many images
+  are loaded. When the image is loaded, the main thread adds it to the
+  pool of shared images and calls \p cb with the image, or with NULL if the
+  image could not be loaded. The callback must release() the image when it
+  is no longer needed.
+
+  Requests for the same image name and size that are made while the image
+  is loaded share the same work, and each callback gets its own reference
+  to the image.
+
+  If the image is already in the pool, it is copied with the requested
+  size if needed and \p cb is called before get_async() returns. If FLTK
+  was built without thread support, the image is loaded like with get(),
+  and \p cb is called before get_async() returns as well.
+
+  \note The worker threads use Fl::awake() to notify the main thread, so
+    the program must call Fl::lock() once before it calls get_async(), as
+    for any program that uses threads with FLTK.
+
+  \note The image handlers are called by the worker threads. They must not
+    call functions that are reserved for the main thread, like
+    Fl::add_timeout() or get(), see loading_async(). The handlers of the
+    fltk_images library load animated GIF files as Fl_GIF_Image, i.e.
+    without animation, even if Fl_GIF_Image::animate is set.
+
+  \param[in] name name of the image file
+  \param[in] W, H desired size, or 0 for the size of the image file
+  \param[in] cb   callback called in the main thread with the image
+  \param[in] data user data passed to \p cb
+
+  \return a request id for cancel_async(), or 0 if \p cb was already called
+
+  \see get(const char *name, int W, int H), cancel_async()
+  \since 1.5.0
+*/
+int Fl_Shared_Image::get_async(const char *name, int W, int H,
+                               Fl_Shared_Image_Callback *cb, void *data) {
+  Fl_Shared_Image *img = find(name, W, H);
+  if (img) {
+    cb(img, data);
+    return 0;
+  }
+#if FL_ASYNC_IMAGES
+  if ((img = find(name)) != NULL) {
+    // only a copy is needed, no file is read
+    img->release();
+    cb(get(name, W, H), data);
+    return 0;
+  }
+
+  if (++last_id <= 0) last_id = 1;
+  Waiter waiter = { last_id, cb, data };
+  for (size_t i = 0; i < jobs.size(); i++) {
+    Job *job = jobs[i];
+    if (job->W == W && job->H == H && job->name == name) {
+      job->waiters.push_back(waiter);
+      return waiter.id;
+    }
+  }
+
+  if (!pool) {
+    pool = new Pool;
+    unsigned n = std::thread::hardware_concurrency();
+    if (n < 1) n = 1;
+    if (n > 4) n = 4;
+    for (unsigned i = 0; i < n; i++)
+      std::thread(async_worker_).detach();
+  }
+
+  Job *job = new Job;
+  job->name = name;
+  job->W = W;
+  job->H = H;
+  job->waiters.push_back(waiter);
+  job->started = false;
+  job->image = job->sized = NULL;
+  jobs.push_back(job);
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->queue.push_back(job);
+  }
+  pool->cond.notify_one();
+  return waiter.id;
+#else
+  cb(get(name, W, H), data);
+  return 0;
+#endif // FL_ASYNC_IMAGES
+}
+
+/**
+  Cancels a request made with get_async().
+
+  The callback of the request will not be called. The image is not loaded
+  if no other request for it is pending and a worker thread did not start
+  to load it yet. Unknown or finished requests are ignored.
+
+  \param[in] id request id returned by get_async()
+  \see get_async()
+  \since 1.5.0
+*/
+void Fl_Shared_Image::cancel_async(int id) {
+#if FL_ASYNC_IMAGES
+  for (size_t i = 0; i < jobs.size(); i++) {
+    Job *job = jobs[i];
+    for (size_t j = 0; j < job->waiters.size(); j++) {
+      if (job->waiters[j].id != id) continue;
+      job->waiters.erase(job->waiters.begin() + j);
+      if (job->waiters.empty()) {
+        // remove the job if no thread has taken it yet
+        bool remove = false;
+        {
+          std::lock_guard<std::mutex> lock(pool->mutex);
+          if (!job->started) {
+            for (size_t k = 0; k < pool->queue.size(); k++) {
+              if (pool->queue[k] == job) {
+                pool->queue.erase(pool->queue.begin() + k);
+                break;
+              }
+            }
+            remove = true;
+          }
+        }
+        if (remove) {
+          jobs.erase(jobs.begin() + i);
+          delete job;
+        }
+      }
+      return;
+    }
+  }
+#else
+  (void)id;
+#endif // FL_ASYNC_IMAGES
+}
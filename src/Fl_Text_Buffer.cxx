@@ -80,6 +80,10 @@ static int min(int i1, int i2)
  called a yankcut, and the number of bytes that were deleted is stored in
  `undoyankcut`, again storing the deleted text in `undobuffer`.
 
+ Deleting text before `undoat` (backspace) or at `undoat` (delete key) adds
+ the deleted text to the current action, so a run of deletions is undone in
+ one step like a run of typed text.
+
  If an undo action is run, text is deleted and inserted via the normal
  Fl_Text_Editor methods, generating the inverse undo action (redo) in mUndo.
  */
@@ -107,15 +111,26 @@ public:
 
   /*
    Resize the undo buffer to match at least the requested size.
+   If grow is set, the buffer gets room for more, because a run of
+   deletions adds to it with every key stroke.
    */
-  void undobuffersize(int n)
+  void undobuffersize(int n, bool grow = false)
   {
     if (n > undobufferlength) {
-      undobufferlength = n + 128;
+      if (grow && undobufferlength)
+        n += n / 2;
+      undobufferlength = n;
       undobuffer = (char *)realloc(undobuffer, undobufferlength);
     }
   }
 
+  /*
+   Memory used by this action in bytes.
+   */
+  size_t memory() const {
+    return sizeof(*this) + undobufferlength;
+  }
+
   void clear() {
     undocut = undoinsert = 0;
   }
@@ -145,12 +160,14 @@ class Fl_Text_Undo_Action_List {
   int list_size_;
   int list_capacity_;
   bool locked_;
+  size_t memory_;           // memory used by all actions in the list
 public:
   Fl_Text_Undo_Action_List() :
   list_(NULL),
   list_size_(0),
   list_capacity_(0),
-  locked_(false)
+  locked_(false),
+  memory_(0)
   { }
 
   ~Fl_Text_Undo_Action_List() {
@@ -162,22 +179,46 @@ public:
     return list_size_;
   }
 
+  size_t memory() const {
+    return memory_ + list_capacity_ * sizeof(Fl_Text_Undo_Action*);
+  }
+
   void push(Fl_Text_Undo_Action* action) {
     if (list_size_ == list_capacity_) {
-      list_capacity_ += 25;
+      list_capacity_ = list_capacity_ ? list_capacity_ * 2 : 25;
       list_ = (Fl_Text_Undo_Action**)realloc(list_, list_capacity_ * sizeof(Fl_Text_Undo_Action*));
     }
     list_[list_size_++] = action;
+    memory_ += action->memory();
   }
 
   Fl_Text_Undo_Action* pop() {
     if (list_size_ > 0) {
-      return list_[--list_size_];
+      Fl_Text_Undo_Action* action = list_[--list_size_];
+      memory_ -= action->memory();
+      return action;
     } else {
       return NULL;
     }
   }
 
+  /*
+   Delete the oldest actions until the list uses at most max_memory bytes.
+   The newest action is always kept.
+   */
+  void trim(size_t max_memory) {
+    int n = 0;
+    while (n < list_size_ - 1 && memory() > max_memory) {
+      memory_ -= list_[n]->memory();
+      delete list_[n];
+      n++;
+    }
+    if (n) {
+      list_size_ -= n;
+      memmove(list_, list_ + n, list_size_ * sizeof(Fl_Text_Undo_Action*));
+    }
+  }
+
   void clear() {
     if (locked_) return;
     if (list_) {
@@ -189,12 +230,54 @@ public:
     list_ = NULL;
     list_size_ = 0;
     list_capacity_ = 0;
+    memory_ = 0;
   }
 
   void lock() { locked_ = true; }
   void unlock() { locked_ = false; }
 };
 
+/*
+ Changes made between Fl_Text_Buffer::begin_batch() and end_batch().
+
+ The pre-delete callback of each change extends the range to include the
+ text that will be changed, and adds the text before the batch that is new
+ in the range to `deleted`. The modify callback of each change then moves
+ `end` by the number of inserted minus deleted bytes. Both callbacks are
+ not called during the batch.
+ */
+class Fl_Text_Batch {
+public:
+  Fl_Text_Batch() : depth(0), start(-1), end(0), pending(false) { }
+
+  int depth;            // nesting level of begin_batch()
+  int start, end;       // changed range in the current text, start < 0 if none
+  std::string deleted;  // text of the range before the batch
+  bool pending;         // call_modify_callbacks() was called without a change
+
+  /*
+   Extend the range to include start ... end of the current text of buf.
+   */
+  void add(const Fl_Text_Buffer *buf, int s, int e) {
+    if (start < 0) {
+      start = s;
+      end = s;
+    }
+    if (s < start) {
+      char *t = buf->text_range(s, start);
+      deleted.insert(0, t);
+      free(t);
+      start = s;
+    }
+    if (e > end) {
+      char *t = buf->text_range(end, e);
+      deleted += t;
+      free(t);
+      end = e;
+    }
+  }
+};
+
 
 static void def_transcoding_warning_action(Fl_Text_Buffer *text)
 {
@@ -229,6 +312,8 @@ Fl_Text_Buffer::Fl_Text_Buffer(int requestedSize, int preferredGapSize)
   mUndo = new Fl_Text_Undo_Action();
   mUndoList = new Fl_Text_Undo_Action_List();
   mRedoList = new Fl_Text_Undo_Action_List();
+  mUndoMemoryLimit = 0;
+  mBatch = NULL;
   input_file_was_transcoded = 0;
   transcoding_warning_action = def_transcoding_warning_action;
 }
@@ -251,6 +336,7 @@ Fl_Text_Buffer::~Fl_Text_Buffer()
   delete mUndo;
   delete mUndoList;
   delete mRedoList;
+  delete mBatch;
 }
 
 
@@ -700,6 +786,47 @@ void Fl_Text_Buffer::canUndo(char flag)
   mCanUndo = flag;
 }
 
+/**
+ Limit the memory used by undo and redo actions.
+
+ Every undo action keeps a copy of the text it deleted, so the undo history
+ of a large buffer can use a lot of memory. If the limit is exceeded, the
+ oldest undo actions are dropped and can no longer be undone. The most recent
+ action is always kept, even if it exceeds the limit alone.
+
+ \param[in] bytes maximum memory in bytes, or 0 for no limit (the default)
+ \see undo_memory()
+ \since 1.5.0
+ */
+void Fl_Text_Buffer::undo_memory_limit(size_t bytes)
+{
+  mUndoMemoryLimit = bytes;
+  trim_undo();
+}
+
+/**
+ Return the memory used by undo and redo actions in bytes.
+ \see undo_memory_limit(size_t)
+ \since 1.5.0
+ */
+size_t Fl_Text_Buffer::undo_memory() const
+{
+  if (!mCanUndo)
+    return 0;
+  return mUndo->memory() + mUndoList->memory() + mRedoList->memory();
+}
+
+/*
+ Drop the oldest undo actions if the undo memory limit is exceeded.
+ */
+void Fl_Text_Buffer::trim_undo()
+{
+  if (!mCanUndo || !mUndoMemoryLimit)
+    return;
+  size_t other = mUndo->memory() + mRedoList->memory();
+  mUndoList->trim(mUndoMemoryLimit > other ? mUndoMemoryLimit - other : 0);
+}
+
 
 /*
  Change the tab width. This will cause a couple of callbacks and a complete
@@ -1446,6 +1573,7 @@ int Fl_Text_Buffer::insert_(int pos, const char *text, int insertedLength)
         mRedoList->clear();
         mUndoList->push(mUndo);
         mUndo = new Fl_Text_Undo_Action();
+        trim_undo();
       } else {
         // we deleted and inserted at the same position, making this a yankcut
       }
@@ -1468,11 +1596,18 @@ int Fl_Text_Buffer::insert_(int pos, const char *text, int insertedLength)
 void Fl_Text_Buffer::remove_(int start, int end)
 {
   if (start >= end) return;
+  char *undodest = NULL;    // where the deleted text goes in the undo buffer
   if (mCanUndo) {
     if (mUndo->undoat == end && mUndo->undocut) {
-      // continue to remove text at the same cursor position
-      mUndo->undobuffersize(mUndo->undocut + end - start + 1);
+      // continue to remove text before the cursor position
+      mUndo->undobuffersize(mUndo->undocut + end - start + 1, true);
       memmove(mUndo->undobuffer + end - start, mUndo->undobuffer, mUndo->undocut);
+      undodest = mUndo->undobuffer;
+      mUndo->undocut += end - start;
+    } else if (mUndo->undoat == start && mUndo->undocut && !mUndo->undoinsert) {
+      // continue to remove text after the cursor position
+      mUndo->undobuffersize(mUndo->undocut + end - start + 1, true);
+      undodest = mUndo->undobuffer + mUndo->undocut;
       mUndo->undocut += end - start;
     } else {
       // remove text at a new position, so generate a new undo action
@@ -1480,7 +1615,9 @@ void Fl_Text_Buffer::remove_(int start, int end)
       mUndoList->push(mUndo);
       mUndo = new Fl_Text_Undo_Action();
       mUndo->undocut = end - start;
-      mUndo->undobuffersize(mUndo->undocut);
+      mUndo->undobuffersize(mUndo->undocut + 1); // room for apply_undo()'s nul
+      undodest = mUndo->undobuffer;
+      trim_undo();
     }
     mUndo->undoat = start;
     mUndo->undoinsert = 0;
@@ -1489,18 +1626,18 @@ void Fl_Text_Buffer::remove_(int start, int end)
 
   if (start > mGapStart) {
     if (mCanUndo)
-      memcpy(mUndo->undobuffer, mBuf + (mGapEnd - mGapStart) + start,
+      memcpy(undodest, mBuf + (mGapEnd - mGapStart) + start,
              end - start);
     move_gap(start);
   } else if (end < mGapStart) {
     if (mCanUndo)
-      memcpy(mUndo->undobuffer, mBuf + start, end - start);
+      memcpy(undodest, mBuf + start, end - start);
     move_gap(end);
   } else {
     int prelen = mGapStart - start;
     if (mCanUndo) {
-      memcpy(mUndo->undobuffer, mBuf + start, prelen);
-      memcpy(mUndo->undobuffer + prelen, mBuf + mGapEnd, end - start - prelen);
+      memcpy(undodest, mBuf + start, prelen);
+      memcpy(undodest + prelen, mBuf + mGapEnd, end - start - prelen);
     }
   }
 
@@ -1648,6 +1785,15 @@ void Fl_Text_Buffer::call_modify_callbacks(int pos, int nDeleted,
                                            int nInserted, int nRestyled,
                                            const char *deletedText) const {
   IS_UTF8_ALIGNED2(this, pos)
+  if (mBatch && mBatch->depth) {
+    if (nInserted || nDeleted)
+      mBatch->end += nInserted - nDeleted;
+    else if (nRestyled)
+      mBatch->add(this, pos, pos + nRestyled);
+    else
+      mBatch->pending = true;
+    return;
+  }
   for (int i = 0; i < mNModifyProcs; i++)
     (*mModifyProcs[i]) (pos, nInserted, nDeleted, nRestyled,
                         deletedText, mCbArgs[i]);
@@ -1659,11 +1805,92 @@ void Fl_Text_Buffer::call_modify_callbacks(int pos, int nDeleted,
  Unicode safe.
  */
 void Fl_Text_Buffer::call_predelete_callbacks(int pos, int nDeleted) const {
+  if (mBatch && mBatch->depth) {
+    mBatch->add(this, pos, pos + nDeleted);
+    return;
+  }
   for (int i = 0; i < mNPredeleteProcs; i++)
     (*mPredeleteProcs[i]) (pos, nDeleted, mPredeleteCbArgs[i]);
 }
 
 
+/**
+ Start a batch of changes that notifies the callbacks only once.
+
+ Until the matching end_batch(), text can be inserted, removed, and replaced
+ without calling the modify and pre-delete callbacks for each change. Then
+ end_batch() calls them once for the range of text that contains all changes.
+ An attached Fl_Text_Display thus recalculates its line starts and redraws
+ only once, for instance after thousands of changes by a "replace all"
+ command or an automatic reformatting. Undo records each change as usual.
+
+ Batches can be nested, only the outermost end_batch() calls the callbacks.
+
+ \note Widgets that display the buffer must not be drawn during a batch,
+   so the program must not call Fl::check() or Fl::wait() before end_batch().
+
+ \see end_batch()
+ \since 1.5.0
+ */
+void Fl_Text_Buffer::begin_batch()
+{
+  if (!mBatch)
+    mBatch = new Fl_Text_Batch();
+  mBatch->depth++;
+}
+
+/**
+ End a batch of changes that was started with begin_batch().
+
+ If text was changed during the batch, the pre-delete and modify callbacks
+ are called once, as if the range of text that contains all changes was
+ replaced by its new text at once.
+
+ \see begin_batch()
+ \since 1.5.0
+ */
+void Fl_Text_Buffer::end_batch()
+{
+  if (!mBatch || !mBatch->depth || --mBatch->depth)
+    return;
+
+  int start = mBatch->start, end = mBatch->end;
+  bool pending = mBatch->pending;
+  std::string deleted;
+  deleted.swap(mBatch->deleted);
+  mBatch->start = -1;
+  mBatch->end = 0;
+  mBatch->pending = false;
+
+  if (start < 0) {
+    if (pending)
+      call_modify_callbacks(0, 0, 0, 0, NULL);
+    return;
+  }
+
+  int nDeleted = (int)deleted.size(), nInserted = end - start;
+  if (mNPredeleteProcs > 0) {
+    // The pre-delete callbacks must see the text before the batch, so it
+    // is put back temporarily, without touching undo and the selections
+    char *inserted = text_range(start, end);
+    char canUndo = mCanUndo;
+    Fl_Text_Selection primary = mPrimary, secondary = mSecondary, highlight = mHighlight;
+    mCanUndo = 0;
+    remove_(start, end);
+    insert_(start, deleted.c_str(), nDeleted);
+    call_predelete_callbacks(start, nDeleted);
+    remove_(start, start + nDeleted);
+    insert_(start, inserted, nInserted);
+    mCanUndo = canUndo;
+    mPrimary = primary;
+    mSecondary = secondary;
+    mHighlight = highlight;
+    free(inserted);
+  }
+  call_modify_callbacks(start, nDeleted, nInserted, 0, deleted.c_str());
+}
+
+
 /*
  Redisplay a new selected area.
  Unicode safe.
@@ -228,6 +228,9 @@ Fl_Widget::Fl_Widget(int X, int Y, int W, int H, const char* L) {
 
 void Fl_Widget::resize(int X, int Y, int W, int H) {
   x_ = X; y_ = Y; w_ = W; h_ = H;
+  // parent_ is not always a group, see Fl_Value_Input
+  Fl_Group *g = parent_ ? parent_->as_group() : NULL;
+  if (g && g->spatial_index_) g->child_resized_(this);
 }
 
 // this is useful for parent widgets to call to resize children:
@@ -24,6 +24,7 @@
 #include <FL/platform.H>
 #include "Fl_Window_Driver.H"
 #include "Fl_Screen_Driver.H"
+#include "Fl_Private.H"
 #include <FL/Fl_RGB_Image.H>
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Tooltip.H>
@@ -32,6 +33,30 @@
 #include <stdlib.h>
 #include "flstring.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+extern int fl_shortcut_keys(unsigned int keys[3]); // in fl_shortcut.cxx
+
+// Maps the keys of shortcuts to the widgets registered with add_shortcut()
+class Fl_Window::Shortcut_Registry {
+public:
+  struct Entry {
+    int shortcut;
+    Fl_Widget *widget;  // tracked with Fl::Private::track_widget_pointer_()
+  };
+  typedef std::list<Entry> Entry_List; // the addresses of widget must not change
+  std::unordered_map<unsigned int, Entry_List> keys;
+  ~Shortcut_Registry() {
+    std::unordered_map<unsigned int, Entry_List>::iterator it;
+    for (it = keys.begin(); it != keys.end(); ++it) {
+      for (Entry_List::iterator e = it->second.begin(); e != it->second.end(); ++e)
+        Fl::Private::release_tracked_pointer_(e->widget);
+    }
+  }
+};
+
 
 char *Fl_Window::default_xclass_ = 0L;
 
@@ -51,6 +76,7 @@ void Fl_Window::_Fl_Window() {
     labeltype(FL_NO_LABEL);
   }
   flx_ = 0;
+  shortcuts_ = 0;
   xclass_ = 0;
   iconlabel_ = 0;
   resizable(0);
@@ -92,6 +118,7 @@ Fl_Window::~Fl_Window() {
     free(xclass_);
   }
   free_icons();
+  delete shortcuts_;
   delete pWindowDriver;
 }
 
@@ -1049,3 +1076,88 @@ void Fl_Window::is_maximized_(bool b) {
 void Fl_Window::allow_expand_outside_parent() {
   if (parent()) pWindowDriver->allow_expand_outside_parent();
 }
+
+/**
+  Registers a widget that handles a shortcut in this window.
+
+  When the window receives an FL_SHORTCUT event, it is sent to the widgets
+  that were registered for a matching \p shortcut before it is sent to all
+  widgets of the window, as usual, if none of these widgets used it. This
+  makes shortcuts fast in windows with many widgets, for instance when \p w
+  is an Fl_Menu_Bar with many item shortcuts (see Fl_Menu_::shortcut_index()).
+
+  The widget must be a child of this window or of one of its subwindows.
+  It receives the event if it is visible and active. Registering the same
+  shortcut twice for a widget has no effect. The registration is removed
+  automatically when the widget is deleted.
+
+  \param[in] shortcut a shortcut value as used by Fl::test_shortcut()
+  \param[in] w the widget that handles the shortcut
+  \see remove_shortcut(), send_shortcut()
+  \since 1.5.0
+*/
+void Fl_Window::add_shortcut(int shortcut, Fl_Widget *w) {
+  if (!shortcut || !w) return;
+  if (!shortcuts_) shortcuts_ = new Shortcut_Registry;
+  Shortcut_Registry::Entry_List &list = shortcuts_->keys[shortcut & FL_KEY_MASK];
+  for (Shortcut_Registry::Entry_List::iterator e = list.begin(); e != list.end(); ++e) {
+    if (e->shortcut == shortcut && e->widget == w) return;
+  }
+  Shortcut_Registry::Entry entry = { shortcut, w };
+  list.push_back(entry);
+  Fl::Private::track_widget_pointer_(list.back().widget);
+}
+
+/**
+  Removes all shortcuts registered for a widget with add_shortcut().
+  \since 1.5.0
+*/
+void Fl_Window::remove_shortcut(Fl_Widget *w) {
+  if (!shortcuts_) return;
+  std::unordered_map<unsigned int, Shortcut_Registry::Entry_List>::iterator it;
+  for (it = shortcuts_->keys.begin(); it != shortcuts_->keys.end(); ++it) {
+    Shortcut_Registry::Entry_List &list = it->second;
+    for (Shortcut_Registry::Entry_List::iterator e = list.begin(); e != list.end();) {
+      if (e->widget == w) {
+        Fl::Private::release_tracked_pointer_(e->widget);
+        e = list.erase(e);
+      } else {
+        ++e;
+      }
+    }
+  }
+}
+
+/**
+  Sends the current FL_SHORTCUT event to the widgets registered for it.
+
+  Only the widgets registered with add_shortcut() for a shortcut that
+  matches the event are tried. FLTK calls this for the window that
+  receives an FL_SHORTCUT event before the event is sent to its widgets.
+
+  \return 1 if one of the widgets used the event, 0 otherwise
+  \since 1.5.0
+*/
+int Fl_Window::send_shortcut() {
+  if (!shortcuts_) return 0;
+  unsigned int k[3];
+  int nk = fl_shortcut_keys(k);
+  // collect the widgets first: their handle() method may change the registry
+  std::vector<Fl_Widget*> found;
+  for (int i = 0; i < nk; i++) {
+    std::unordered_map<unsigned int, Shortcut_Registry::Entry_List>::iterator it =
+      shortcuts_->keys.find(k[i]);
+    if (it == shortcuts_->keys.end()) continue;
+    Shortcut_Registry::Entry_List &list = it->second;
+    for (Shortcut_Registry::Entry_List::iterator e = list.begin(); e != list.end(); ++e) {
+      Fl_Widget *w = e->widget;
+      if (w && Fl::test_shortcut(e->shortcut) && w->top_window() == this &&
+          w->takesevents() && w->visible_r() && w->active_r())
+        found.push_back(w);
+    }
+  }
+  for (size_t i = 0; i < found.size(); i++) {
+    if (found[i]->handle(FL_SHORTCUT)) return 1;
+  }
+  return 0;
+}
@@ -30,6 +30,7 @@
 #  include <FL/Fl.H>
 #  include <FL/platform.H>
 #  include "Fl_Window_Driver.H"
+#  include "Fl_Private.H"
 #  include <FL/Fl_Window.H>
 #  include <FL/fl_utf8.h>
 #  include <FL/Fl_Tooltip.H>
@@ -106,6 +107,36 @@ extern int fl_send_system_handlers(void *e);
 static Fl_Window *send_motion;
 #endif
 
+// positions of the motion events skipped by compress_motion(), in pixels
+static int motion_skipped;
+static int motion_history[2 * Fl::Private::event_history_max_];
+
+// Replaces a motion event by the last of the motion events for the same
+// window and with the same state that follow it in the event queue.
+// The positions of the replaced events are kept for Fl::event_history().
+static void compress_motion(XEvent &xevent) {
+  XEvent next;
+  motion_skipped = 0;
+  while (XEventsQueued(fl_display, QueuedAlready)) {
+    XPeekEvent(fl_display, &next);
+    if (next.type != MotionNotify ||
+        next.xmotion.window != xevent.xmotion.window ||
+        next.xmotion.state != xevent.xmotion.state)
+      break;
+    XNextEvent(fl_display, &next);
+    if (fl_send_system_handlers(&next))
+      continue;
+    if (motion_skipped == Fl::Private::event_history_max_) { // drop the oldest position
+      memmove(motion_history, motion_history + 2, (2 * motion_skipped - 2) * sizeof(int));
+      motion_skipped--;
+    }
+    motion_history[2 * motion_skipped] = xevent.xmotion.x;
+    motion_history[2 * motion_skipped + 1] = xevent.xmotion.y;
+    motion_skipped++;
+    xevent = next;
+  }
+}
+
 static bool in_a_window; // true if in any of our windows, even destroyed ones
 static void do_queued_events() {
   in_a_window = true;
@@ -114,6 +145,8 @@ static void do_queued_events() {
     XNextEvent(fl_display, &xevent);
     if (fl_send_system_handlers(&xevent))
       continue;
+    if (xevent.type == MotionNotify && Fl::Private::motion_compression_)
+      compress_motion(xevent);
     fl_handle(xevent);
   }
   // we send FL_LEAVE only if the mouse did not enter some other window:
@@ -2160,6 +2193,17 @@ int fl_handle(const XEvent& thisevent)
     set_event_xy(window);
     in_a_window = true;
     fl_xmousewin = window;
+    Fl::Private::event_history_n_ = 0;
+    if (motion_skipped) {
+      float s = 1;
+#if USE_XFT || FLTK_USE_CAIRO
+      s = Fl::screen_driver()->scale(Fl_Window_Driver::driver(window)->screen_num());
+#endif
+      for (int i = 0; i < 2 * motion_skipped; i++)
+        Fl::Private::event_history_xy_[i] = int(motion_history[i] / s);
+      Fl::Private::event_history_n_ = motion_skipped;
+      motion_skipped = 0;
+    }
 
 #if FLTK_CONSOLIDATE_MOTION
     send_motion = window;
@@ -0,0 +1,56 @@
+//
+// Copy-to-clipboard code for the headless backend of the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2010-2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Headless_Copy_Surface_Driver.H"
+#include "Fl_Headless_Graphics_Driver.H"
+#include "Fl_Headless_Screen_Driver.H"
+#include <FL/Fl.H>
+
+
+Fl_Headless_Copy_Surface_Driver::Fl_Headless_Copy_Surface_Driver(int w, int h) : Fl_Copy_Surface_Driver(w, h) {
+  float os_scale = Fl_Graphics_Driver::default_driver().scale();
+  img_surf = new Fl_Image_Surface(int(w * os_scale), int(h * os_scale));
+  driver(img_surf->driver());
+  driver()->scale(os_scale);
+}
+
+
+// the copied image goes to the clipboard kept by the headless screen driver
+Fl_Headless_Copy_Surface_Driver::~Fl_Headless_Copy_Surface_Driver() {
+  Fl_RGB_Image *rgb = img_surf->image();
+  Fl_Headless_Screen_Driver *scr_driver = (Fl_Headless_Screen_Driver*)Fl::screen_driver();
+  scr_driver->copy_image(rgb->array, rgb->data_w(), rgb->data_h());
+  delete rgb;
+  delete img_surf;
+  driver(NULL);
+}
+
+
+void Fl_Headless_Copy_Surface_Driver::set_current() {
+  Fl_Surface_Device::set_current();
+  Fl_Cairo_Graphics_Driver *dr = (Fl_Cairo_Graphics_Driver*)driver();
+  if (!dr->cr()) dr->set_cairo((cairo_t*)img_surf->offscreen());
+}
+
+
+void Fl_Headless_Copy_Surface_Driver::translate(int x, int y) {
+  ((Fl_Headless_Graphics_Driver*)driver())->ps_translate(x, y);
+}
+
+
+void Fl_Headless_Copy_Surface_Driver::untranslate() {
+  ((Fl_Headless_Graphics_Driver*)driver())->ps_untranslate();
+}
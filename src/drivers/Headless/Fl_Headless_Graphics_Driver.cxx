@@ -0,0 +1,88 @@
+//
+// Implementation of the headless graphics driver.
+//
+// Copyright 2010-2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Headless_Graphics_Driver.H"
+#include <FL/Fl.H>
+#include <cairo/cairo.h>
+#include <string.h>
+
+
+void Fl_Headless_Graphics_Driver::cairo_init(struct draw_buffer *buffer,
+                                             int width, int height,
+                                             cairo_format_t format) {
+  buffer->stride = cairo_format_stride_for_width(format, width);
+  buffer->data_size = size_t(buffer->stride) * height;
+  buffer->buffer = new uchar[buffer->data_size];
+  buffer->width = width;
+  cairo_surface_t *surf = cairo_image_surface_create_for_data(buffer->buffer, format,
+                                                              width, height, buffer->stride);
+  if (cairo_surface_status(surf) != CAIRO_STATUS_SUCCESS) {
+    Fl::fatal("Can't create Cairo surface with cairo_image_surface_create_for_data()\n");
+    return;
+  }
+  buffer->cairo_ = cairo_create(surf);
+  cairo_status_t err;
+  if ((err = cairo_status(buffer->cairo_)) != CAIRO_STATUS_SUCCESS) {
+    Fl::fatal("Cairo error during cairo_create() %s\n", cairo_status_to_string(err));
+    return;
+  }
+  cairo_surface_destroy(surf);
+  memset(buffer->buffer, 0, buffer->data_size);
+  cairo_set_source_rgba(buffer->cairo_, .0, .0, .0, 1.0); // Black default color
+  cairo_save(buffer->cairo_);
+}
+
+
+void Fl_Headless_Graphics_Driver::cairo_release(struct draw_buffer *buffer) {
+  if (!buffer->buffer) return;
+  cairo_destroy(buffer->cairo_);
+  delete[] buffer->buffer;
+  buffer->buffer = NULL;
+  buffer->cairo_ = NULL;
+}
+
+
+void Fl_Headless_Graphics_Driver::copy_offscreen(int x, int y, int w, int h,
+                                                 Fl_Offscreen src, int srcx, int srcy) {
+  // draw portion srcx,srcy,w,h of osrc to position x,y (top-left) of
+  // the graphics driver's surface
+  cairo_matrix_t matrix;
+  cairo_get_matrix(cairo_, &matrix);
+  double s = matrix.xx;
+  cairo_save(cairo_);
+  cairo_rectangle(cairo_, x - 0.5, y - 0.5, w, h);
+  cairo_set_antialias(cairo_, CAIRO_ANTIALIAS_NONE);
+  cairo_clip(cairo_);
+  cairo_set_antialias(cairo_, CAIRO_ANTIALIAS_DEFAULT);
+  cairo_surface_t *surf = cairo_get_target((cairo_t *)src);
+  cairo_pattern_t *pat = cairo_pattern_create_for_surface(surf);
+  cairo_set_source(cairo_, pat);
+  cairo_matrix_init_scale(&matrix, s, s);
+  cairo_matrix_translate(&matrix, -(x - srcx), -(y - srcy));
+  cairo_pattern_set_matrix(pat, &matrix);
+  cairo_paint(cairo_);
+  cairo_pattern_destroy(pat);
+  cairo_restore(cairo_);
+}
+
+
+const cairo_user_data_key_t Fl_Headless_Graphics_Driver::key = {};
+
+
+struct Fl_Headless_Graphics_Driver::draw_buffer*
+Fl_Headless_Graphics_Driver::offscreen_buffer(Fl_Offscreen offscreen) {
+  return (struct draw_buffer*)cairo_get_user_data((cairo_t*)offscreen, &key);
+}
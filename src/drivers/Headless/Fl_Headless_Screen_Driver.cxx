@@ -0,0 +1,419 @@
+//
+// Implementation of the headless Screen interface
+// for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 1998-2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <config.h>
+#include "Fl_Headless_Screen_Driver.H"
+#include "Fl_Headless_Window_Driver.H"
+#include "Fl_Headless_Graphics_Driver.H"
+#include "../Unix/Fl_Unix_System_Driver.H"
+#include "../../Fl_Scalable_Graphics_Driver.H"
+#include <FL/Fl.H>
+#include <FL/platform.H>
+#include <FL/headless.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/fl_draw.H>
+#include <FL/fl_utf8.h>
+#include <cairo/cairo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+extern const char *fl_bg;
+extern const char *fl_bg2;
+extern const char *fl_fg;
+
+
+Fl_Headless_Screen_Driver::Fl_Headless_Screen_Driver() : Fl_Unix_Screen_Driver() {
+  screen_w_ = 1920;
+  screen_h_ = 1080;
+  dpi_ = 96;
+  scale_ = 1;
+  mouse_x_ = mouse_y_ = 0;
+  for (int i = 0; i < 2; i++) {
+    selection_buffer_[i] = NULL;
+    selection_length_[i] = 0;
+    selection_type_[i] = NULL;
+  }
+  memset(pressed_keys_, 0, sizeof(pressed_keys_));
+}
+
+
+Fl_Headless_Screen_Driver::~Fl_Headless_Screen_Driver() {
+  for (int i = 0; i < 2; i++) delete[] selection_buffer_[i];
+}
+
+
+void Fl_Headless_Screen_Driver::init() {
+  num_screens = 1;
+  const char *size = fl_getenv("FLTK_HEADLESS_SCREEN");
+  int W, H;
+  if (size && sscanf(size, "%dx%d", &W, &H) == 2 && W > 0 && H > 0) {
+    screen_w_ = W;
+    screen_h_ = H;
+  }
+}
+
+
+void Fl_Headless_Screen_Driver::screen_xywh(int &X, int &Y, int &W, int &H, int n) {
+  (void)n;
+  if (num_screens < 0) init();
+  X = 0;
+  Y = 0;
+  W = int(screen_w_ / scale_);
+  H = int(screen_h_ / scale_);
+}
+
+
+void Fl_Headless_Screen_Driver::screen_dpi(float &h, float &v, int n) {
+  (void)n;
+  h = v = dpi_;
+}
+
+
+static void getsyscolor(const char *arg, const char *defarg, void (*func)(uchar,uchar,uchar)) {
+  uchar r, g, b;
+  if (!arg) arg = defarg;
+  if (!Fl::screen_driver()->parse_color(arg, r, g, b))
+    Fl::error("Unknown color: %s", arg);
+  else
+    func(r, g, b);
+}
+
+
+static void set_selection_color(uchar r, uchar g, uchar b) {
+  Fl::set_color(FL_SELECTION_COLOR, r, g, b);
+}
+
+
+void Fl_Headless_Screen_Driver::get_system_colors() {
+  open_display();
+  if (!bg2_set) getsyscolor(fl_bg2, "#ffffff", Fl::background2);
+  if (!fg_set)  getsyscolor(fl_fg,  "#000000", Fl::foreground);
+  if (!bg_set)  getsyscolor(fl_bg,  "#c0c0c0", Fl::background);
+  getsyscolor(0, "#000080", set_selection_color);
+}
+
+
+int Fl_Headless_Screen_Driver::compose(int &del) {
+  unsigned char ascii = (unsigned char)Fl::e_text[0];
+  // letter+modifier key is treated as a function key
+  if ((Fl::e_state & (FL_ALT | FL_META | FL_CTRL)) && ascii < 128) { del = 0; return 0; }
+  del = Fl::compose_state;
+  Fl::compose_state = 0;
+  // only insert non-control characters
+  if (!ascii || ascii <= 31 || ascii == 127) { del = 0; return 0; }
+  return 1;
+}
+
+
+Fl_RGB_Image *Fl_Headless_Screen_Driver::read_win_rectangle(int X, int Y, int w, int h,
+                                                            Fl_Window *win,
+                                                            bool ignore, bool *p_ignore) {
+  (void)ignore; (void)p_ignore;
+  struct Fl_Headless_Graphics_Driver::draw_buffer *buffer;
+  float s;
+  if (win) {
+    struct Fl_Headless_Window_Driver::raster *r = Fl_Headless_Window_Driver::raster(win);
+    if (!r || !r->buffer.buffer) return NULL;
+    buffer = &r->buffer;
+    s = r->scale;
+  } else {
+    Fl_Image_Surface_Driver *dr = (Fl_Image_Surface_Driver*)Fl_Surface_Device::surface();
+    buffer = Fl_Headless_Graphics_Driver::offscreen_buffer(dr->image_surface()->offscreen());
+    s = Fl_Surface_Device::surface()->driver()->scale();
+  }
+  cairo_surface_flush(cairo_get_target(buffer->cairo_));
+  int Xs, Ys, ws, hs;
+  if (s == 1) {
+    Xs = X; Ys = Y; ws = w; hs = h;
+  } else {
+    Xs = Fl_Scalable_Graphics_Driver::floor(X, s);
+    Ys = Fl_Scalable_Graphics_Driver::floor(Y, s);
+    ws = Fl_Scalable_Graphics_Driver::floor(X+w, s) - Xs;
+    hs = Fl_Scalable_Graphics_Driver::floor(Y+h, s) - Ys;
+  }
+  int buffer_h = int(buffer->data_size / buffer->stride);
+  if (Xs < 0) { ws += Xs; Xs = 0; }
+  if (Ys < 0) { hs += Ys; Ys = 0; }
+  if (Xs + ws > buffer->width) ws = buffer->width - Xs;
+  if (Ys + hs > buffer_h) hs = buffer_h - Ys;
+  if (ws <= 0 || hs <= 0) return NULL;
+  uchar *data = new uchar[ws * hs * 3];
+  uchar *p = data, *q;
+  for (int j = 0; j < hs; j++) {
+    q = buffer->buffer + (j+Ys) * buffer->stride + 4 * Xs;
+    for (int i = 0; i < ws; i++) {
+      *p++ = *(q+2); // R
+      *p++ = *(q+1); // G
+      *p++ = *q;     // B
+      q += 4;
+    }
+  }
+  Fl_RGB_Image *rgb = new Fl_RGB_Image(data, ws, hs, 3);
+  rgb->alloc_array = 1;
+  return rgb;
+}
+
+
+int Fl_Headless_Screen_Driver::get_mouse(int &xx, int &yy) {
+  xx = int(mouse_x_ / scale_);
+  yy = int(mouse_y_ / scale_);
+  return 0;
+}
+
+
+void Fl_Headless_Screen_Driver::offscreen_size(Fl_Offscreen off_, int &width, int &height) {
+  struct Fl_Headless_Graphics_Driver::draw_buffer *off =
+    Fl_Headless_Graphics_Driver::offscreen_buffer(off_);
+  width = off->width;
+  height = int(off->data_size / off->stride);
+}
+
+
+void Fl_Headless_Screen_Driver::copy(const char *stuff, int len, int clipboard,
+                                     const char *type) {
+  if (!stuff || len < 0) return;
+  if (clipboard >= 2) clipboard = 1;
+  delete[] selection_buffer_[clipboard];
+  selection_buffer_[clipboard] = new char[len + 1];
+  memcpy(selection_buffer_[clipboard], stuff, len);
+  selection_buffer_[clipboard][len] = 0; // needed for direct paste
+  selection_length_[clipboard] = len;
+  selection_type_[clipboard] = Fl::clipboard_plain_text;
+  (void)type;
+}
+
+
+// Stores an RGB image in the clipboard, in the BMP format used by other Unix platforms.
+void Fl_Headless_Screen_Driver::copy_image(const unsigned char *data, int W, int H) {
+  delete[] selection_buffer_[1];
+  selection_buffer_[1] =
+    (char *)Fl_Unix_System_Driver::create_bmp(data, W, H, &selection_length_[1]);
+  selection_type_[1] = Fl::clipboard_image;
+}
+
+
+void Fl_Headless_Screen_Driver::paste(Fl_Widget &receiver, int clipboard, const char *type) {
+  if (clipboard >= 2) clipboard = 1;
+  if (!selection_buffer_[clipboard] || selection_type_[clipboard] != type) return;
+  if (type == Fl::clipboard_plain_text) {
+    Fl::e_text = selection_buffer_[clipboard];
+    Fl::e_length = selection_length_[clipboard];
+    receiver.handle(FL_PASTE);
+  } else if (type == Fl::clipboard_image) {
+    Fl::e_clipboard_data = Fl_Unix_System_Driver::own_bmp_to_RGB(selection_buffer_[clipboard]);
+    Fl::e_clipboard_type = Fl::clipboard_image;
+    int done = receiver.handle(FL_PASTE);
+    Fl::e_clipboard_type = "";
+    if (done == 0) {
+      delete (Fl_RGB_Image*)Fl::e_clipboard_data;
+      Fl::e_clipboard_data = NULL;
+    }
+  }
+}
+
+
+int Fl_Headless_Screen_Driver::clipboard_contains(const char *type) {
+  return selection_buffer_[1] && selection_type_[1] == type;
+}
+
+
+void Fl_Headless_Screen_Driver::key_state(int k, bool pressed) {
+  if (k < 0 || k >= 0x10000) return;
+  if (pressed) pressed_keys_[k >> 3] |= (1 << (k & 7));
+  else pressed_keys_[k >> 3] &= ~(1 << (k & 7));
+}
+
+
+int Fl_Headless_Screen_Driver::event_key(int k) {
+  if (k > FL_Button && k <= FL_Button + 3)
+    return Fl::event_state(FL_BUTTON1 << (k - FL_Button - 1));
+  if (k < 0 || k >= 0x10000) return 0;
+  if (k >= 'A' && k <= 'Z') k += 'a' - 'A'; // keys are recorded lowercase
+  return (pressed_keys_[k >> 3] >> (k & 7)) & 1;
+}
+
+
+// ---- synthetic event injection, see <FL/headless.H>
+
+/**
+ Returns true when the program runs with the headless backend.
+ The headless backend is selected by setting environment variable FLTK_BACKEND
+ to "headless" before the display is opened.
+ */
+bool fl_headless_backend() {
+  static int headless = -1;
+  if (headless < 0) { // get the value once and cache it
+    const char *backend = ::getenv("FLTK_BACKEND");
+    headless = (backend && strcmp(backend, "headless") == 0) ? 1 : 0;
+  }
+  return headless == 1;
+}
+
+
+static Fl_Headless_Screen_Driver *headless_driver() {
+  if (!fl_headless_backend()) return NULL;
+  fl_open_display();
+  return (Fl_Headless_Screen_Driver*)Fl::screen_driver();
+}
+
+
+static int px, py;
+static Fl_Timestamp ptime;
+
+static void set_event_xy(Fl_Window *win, int x, int y) {
+  Fl::e_x = x;
+  Fl::e_y = y;
+  Fl::e_x_root = win->x_root() + x;
+  Fl::e_y_root = win->y_root() + y;
+  float s = Fl::screen_scale(0);
+  headless_driver()->mouse_position(int(Fl::e_x_root * s), int(Fl::e_y_root * s));
+  // a click is cancelled by moving the mouse, or by a long delay
+  if (abs(Fl::e_x_root - px) + abs(Fl::e_y_root - py) > 3 || Fl::seconds_since(ptime) >= 1.0)
+    Fl::e_is_click = 0;
+}
+
+
+static void checkdouble() {
+  if (Fl::e_is_click == Fl::e_keysym) {
+    Fl::e_clicks++;
+  } else {
+    Fl::e_clicks = 0;
+    Fl::e_is_click = Fl::e_keysym;
+  }
+  px = Fl::e_x_root;
+  py = Fl::e_y_root;
+  ptime = Fl::now();
+}
+
+
+/**
+ Sends a synthetic mouse event to a window of the headless backend.
+
+ The event is processed as if the windowing system had reported it: the
+ position, buttons state and click count are updated before the event is
+ dispatched with Fl::handle().
+
+ \param[in] win    the receiving window, may be a subwindow
+ \param[in] event  one of FL_PUSH, FL_RELEASE, FL_MOVE or FL_DRAG.
+                   FL_MOVE and FL_DRAG are equivalent: the event is sent as
+                   FL_DRAG while a mouse button is down.
+ \param[in] x,y    the mouse position relative to \p win
+ \param[in] button the mouse button (1, 2 or 3) for FL_PUSH and FL_RELEASE
+ \return the value returned by Fl::handle(), or 0 if the headless backend is not active
+ */
+int fl_headless_mouse_event(Fl_Window *win, int event, int x, int y, int button) {
+  if (!win || !win->shown() || !headless_driver()) return 0;
+  set_event_xy(win, x, y);
+  if (event == FL_PUSH || event == FL_RELEASE) {
+    if (button < 1 || button > 3) button = 1;
+    Fl::e_keysym = FL_Button + button;
+    if (event == FL_PUSH) {
+      checkdouble();
+      Fl::e_state |= (FL_BUTTON1 << (button - 1));
+    } else {
+      Fl::e_state &= ~(FL_BUTTON1 << (button - 1));
+    }
+  } else {
+    event = (Fl::e_state & FL_BUTTONS) ? FL_DRAG : FL_MOVE;
+  }
+  return Fl::handle(event, win);
+}
+
+
+/**
+ Sends a synthetic mouse wheel event to a window of the headless backend.
+ \param[in] win    the receiving window, may be a subwindow
+ \param[in] x,y    the mouse position relative to \p win
+ \param[in] dx,dy  the horizontal and vertical scroll amounts
+ \return the value returned by Fl::handle(), or 0 if the headless backend is not active
+ */
+int fl_headless_mousewheel_event(Fl_Window *win, int x, int y, int dx, int dy) {
+  if (!win || !win->shown() || !headless_driver()) return 0;
+  set_event_xy(win, x, y);
+  Fl::e_dx = dx;
+  Fl::e_dy = dy;
+  return Fl::handle(FL_MOUSEWHEEL, win);
+}
+
+
+static int modifier_of_key(int key) {
+  switch (key) {
+    case FL_Shift_L: case FL_Shift_R: return FL_SHIFT;
+    case FL_Control_L: case FL_Control_R: return FL_CTRL;
+    case FL_Alt_L: case FL_Alt_R: return FL_ALT;
+    case FL_Meta_L: case FL_Meta_R: return FL_META;
+    default: return 0;
+  }
+}
+
+
+/**
+ Sends a synthetic keyboard event to a window of the headless backend.
+
+ Modifier keys (e.g. FL_Shift_L or FL_Control_R) update Fl::event_state()
+ and remain active until their FL_KEYUP event is sent. FL_Caps_Lock toggles
+ FL_CAPS_LOCK with each FL_KEYDOWN.
+
+ \param[in] win   the receiving window
+ \param[in] event FL_KEYDOWN or FL_KEYUP
+ \param[in] key   the key symbol, e.g. 'a', FL_Enter or FL_Left
+ \param[in] text  the UTF-8 text the key produces. If NULL, printable ASCII
+                  keys produce their own character, taking the state of the
+                  Shift and Caps Lock keys into account.
+ \return the value returned by Fl::handle(), or 0 if the headless backend is not active
+ */
+int fl_headless_key_event(Fl_Window *win, int event, int key, const char *text) {
+  Fl_Headless_Screen_Driver *driver = headless_driver();
+  if (!win || !win->shown() || !driver) return 0;
+  static char buffer[2];
+  Fl::e_keysym = Fl::e_original_keysym = key;
+  int modifier = modifier_of_key(key);
+  if (event == FL_KEYDOWN) {
+    if (modifier) Fl::e_state |= modifier;
+    else if (key == FL_Caps_Lock) Fl::e_state ^= FL_CAPS_LOCK;
+    if (!text) {
+      buffer[0] = 0;
+      if (key >= ' ' && key < 127) {
+        int upper = (Fl::e_state & FL_SHIFT) ? 1 : 0;
+        if (Fl::e_state & FL_CAPS_LOCK) upper = !upper;
+        buffer[0] = char((upper && key >= 'a' && key <= 'z') ? key - 'a' + 'A' : key);
+      } else if (key == FL_Enter || key == FL_KP_Enter) {
+        buffer[0] = '\r';
+      } else if (key == FL_Tab) {
+        buffer[0] = '\t';
+      } else if (key == FL_BackSpace) {
+        buffer[0] = '\b';
+      } else if (key == FL_Escape) {
+        buffer[0] = 27;
+      }
+      buffer[1] = 0;
+      text = buffer;
+    }
+    Fl::e_text = (char*)text;
+    Fl::e_length = (int)strlen(text);
+  } else {
+    event = FL_KEYUP;
+    Fl::e_text = (char*)"";
+    Fl::e_length = 0;
+  }
+  driver->key_state(key >= 'A' && key <= 'Z' ? key + 'a' - 'A' : key, event == FL_KEYDOWN);
+  int ret = Fl::handle(event, win);
+  if (event == FL_KEYUP && modifier) Fl::e_state &= ~modifier;
+  return ret;
+}
@@ -0,0 +1,192 @@
+//
+// Implementation of the headless window driver.
+//
+// Copyright 1998-2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <config.h>
+#include "Fl_Headless_Window_Driver.H"
+#include "Fl_Headless_Screen_Driver.H"
+#include "../../Fl_Screen_Driver.H"
+#include <FL/Fl.H>
+#include <FL/platform.H>
+#include <FL/fl_ask.H>
+#include <cairo/cairo.h>
+#include <stdlib.h>
+
+
+struct Fl_Headless_Window_Driver::raster *Fl_Headless_Window_Driver::raster(const Fl_Window *win) {
+  Fl_X *flx = Fl_X::flx(win);
+  return flx ? (struct raster*)flx->xid : NULL;
+}
+
+
+void Fl_Headless_Window_Driver::release_buffer(struct raster *r) {
+  if (r) Fl_Headless_Graphics_Driver::cairo_release(&r->buffer);
+}
+
+
+fl_uintptr_t Fl_Headless_Window_Driver::os_id() {
+  return (fl_uintptr_t)raster(pWindow);
+}
+
+
+void Fl_Headless_Window_Driver::makeWindow() {
+  struct raster *new_raster = (struct raster*)calloc(1, sizeof(struct raster));
+  new_raster->fl_win = pWindow;
+  screen_num(parent() ? pWindow->top_window()->screen_num() : 0);
+
+  Fl_X *xp = new Fl_X;
+  xp->xid = (fl_uintptr_t)new_raster;
+  other_xid = 0;
+  xp->w = pWindow;
+  flx(xp);
+  xp->region = 0;
+  if (!pWindow->parent()) {
+    xp->next = Fl_X::first;
+    Fl_X::first = xp;
+  } else if (Fl_X::first) {
+    xp->next = Fl_X::first->next;
+    Fl_X::first->next = xp;
+  } else {
+    xp->next = NULL;
+    Fl_X::first = xp;
+  }
+  if (pWindow->modal()) Fl::modal_ = pWindow;
+
+  // there is no compositor to wait for: the window is mapped immediately
+  wait_for_expose_value = 0;
+  size_range();
+  pWindow->set_visible();
+  int old_event = Fl::e_number;
+  pWindow->redraw();
+  pWindow->handle(Fl::e_number = FL_SHOW); // get child windows to appear
+  Fl::e_number = old_event;
+  if (!pWindow->parent() && !popup_window() && !pWindow->tooltip_window() &&
+      !pWindow->menu_window()) {
+    Fl::handle(FL_FOCUS, pWindow);
+  }
+}
+
+
+void Fl_Headless_Window_Driver::show() {
+  if (!shown()) {
+    fl_open_display();
+    makeWindow();
+  } else {
+    Fl::handle(FL_SHOW, pWindow);
+  }
+}
+
+
+// make drawing go into this window's image buffer
+void Fl_Headless_Window_Driver::make_current() {
+  if (!shown()) {
+    static const char err_message[] = "Fl_Window::make_current(), but window is not shown().";
+    fl_alert(err_message);
+    Fl::fatal(err_message);
+  }
+  struct raster *r = raster(pWindow);
+  float f = Fl::screen_scale(pWindow->screen_num());
+  if (r->buffer.buffer && r->scale != f) release_buffer(r);
+  if (!r->buffer.buffer) {
+    int W = int(pWindow->w() * f), H = int(pWindow->h() * f);
+    if (W < 1) W = 1;
+    if (H < 1) H = 1;
+    Fl_Headless_Graphics_Driver::cairo_init(&r->buffer, W, H,
+                                            Fl_Cairo_Graphics_Driver::cairo_format);
+    r->scale = f;
+    // windows are opaque, start from the window's background color
+    pWindow->damage(FL_DAMAGE_ALL);
+  }
+  fl_window = (Window)r;
+  Fl_Cairo_Graphics_Driver *dr = (Fl_Cairo_Graphics_Driver*)fl_graphics_driver;
+  dr->set_cairo(r->buffer.cairo_, f);
+  fl_graphics_driver->clip_region(0);
+
+#ifdef FLTK_HAVE_CAIROEXT
+  // update the cairo_t context
+  if (Fl::cairo_autolink_context()) Fl::cairo_make_current(pWindow);
+#endif
+}
+
+
+void Fl_Headless_Window_Driver::flush() {
+  if (!pWindow->damage()) return;
+  Fl_Window_Driver::flush();
+  struct raster *r = raster(pWindow);
+  if (r && r->buffer.cairo_) cairo_surface_flush(cairo_get_target(r->buffer.cairo_));
+}
+
+
+void Fl_Headless_Window_Driver::resize(int X, int Y, int W, int H) {
+  int is_a_move = (X != x() || Y != y());
+  int is_a_resize = (W != w() || H != h() || Fl_Window::is_a_rescale());
+  if (is_a_move) force_position(1);
+  else if (!is_a_resize) return;
+  if (is_a_resize) {
+    if (pWindow->parent()) {
+      if (W < 1) W = 1;
+      if (H < 1) H = 1;
+    }
+    pWindow->Fl_Group::resize(X, Y, W, H);
+    if (shown()) {
+      if (pWindow->as_overlay_window() && other_xid) destroy_double_buffer();
+      release_buffer(raster(pWindow)); // the new size is allocated at next make_current()
+      pWindow->redraw();
+    }
+  } else {
+    x(X); y(Y);
+  }
+}
+
+
+void Fl_Headless_Window_Driver::hide() {
+  Fl_X* ip = Fl_X::flx(pWindow);
+  if (hide_common()) return;
+  if (ip->region) {
+    Fl_Graphics_Driver::default_driver().XDestroyRegion(ip->region);
+    ip->region = 0;
+  }
+  screen_num_ = -1;
+  struct raster *r = (struct raster*)ip->xid;
+  if (r) {
+    release_buffer(r);
+    if (fl_window == (Window)r) fl_window = 0;
+    free(r);
+  }
+  delete ip;
+}
+
+
+void Fl_Headless_Window_Driver::fullscreen_on() {
+  pWindow->_set_fullscreen();
+  int X, Y, W, H;
+  Fl::screen_xywh(X, Y, W, H, screen_num());
+  pWindow->resize(X, Y, W, H);
+  Fl::handle(FL_FULLSCREEN, pWindow);
+}
+
+
+void Fl_Headless_Window_Driver::fullscreen_off(int X, int Y, int W, int H) {
+  pWindow->_clear_fullscreen();
+  if (!W) W = w();
+  if (!H) H = h();
+  pWindow->resize(X, Y, W, H);
+  Fl::handle(FL_FULLSCREEN, pWindow);
+}
+
+
+void Fl_Headless_Window_Driver::iconize() {
+  Fl::handle(FL_HIDE, pWindow);
+}
@@ -17,6 +17,7 @@
 #include <config.h>
 #if HAVE_GL
 #include <FL/platform.H>
+#include <FL/headless.H>
 #include <FL/Fl_Image_Surface.H>
 #include "../../Fl_Gl_Choice.H"
 #include "../../../libdecor/build/fl_libdecor.h"
@@ -84,6 +85,10 @@ Fl_Wayland_Gl_Window_Driver::Fl_Wayland_Gl_Window_Driver(Fl_Gl_Window *win) :
 
 Fl_Gl_Window_Driver *Fl_Gl_Window_Driver::newGlWindowDriver(Fl_Gl_Window *w)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend())
+    Fl::fatal("OpenGL windows are not supported by the headless backend");
+#endif
 #ifdef FLTK_USE_X11
   if (!Fl_Wayland_Screen_Driver::wl_display) return new Fl_X11_Gl_Window_Driver(w);
 #endif
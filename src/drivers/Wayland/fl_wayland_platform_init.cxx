@@ -21,6 +21,14 @@
 #include "../Unix/Fl_Unix_System_Driver.H"
 #include "Fl_Wayland_Window_Driver.H"
 #include "Fl_Wayland_Image_Surface_Driver.H"
+#if FLTK_USE_HEADLESS
+#  include <FL/headless.H>
+#  include "../Headless/Fl_Headless_Copy_Surface_Driver.H"
+#  include "../Headless/Fl_Headless_Graphics_Driver.H"
+#  include "../Headless/Fl_Headless_Image_Surface_Driver.H"
+#  include "../Headless/Fl_Headless_Screen_Driver.H"
+#  include "../Headless/Fl_Headless_Window_Driver.H"
+#endif
 #if FLTK_HAVE_PEN_SUPPORT
 #  include "../Base/Fl_Base_Pen_Events.H"
 #endif
@@ -97,6 +105,9 @@ Fl_System_Driver *Fl_System_Driver::newSystemDriver() {
 
 
 Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver() {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Graphics_Driver();
+#endif
 #ifdef FLTK_USE_X11
   if (!attempt_wayland()) return new Fl_X11_Cairo_Graphics_Driver();
 #endif
@@ -105,6 +116,9 @@ Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver() {
 
 
 Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int h) {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Copy_Surface_Driver(w, h);
+#endif
 #ifdef FLTK_USE_X11
   if (!Fl_Wayland_Screen_Driver::wl_display) return new Fl_Xlib_Copy_Surface_Driver(w, h);
 #endif
@@ -114,6 +128,9 @@ Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int
 
 Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver() {
   if (!Fl_Screen_Driver::system_driver) Fl::system_driver();
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Screen_Driver();
+#endif
 #ifdef FLTK_USE_X11
   if (attempt_wayland()) {
     return new Fl_Wayland_Screen_Driver();
@@ -131,6 +148,9 @@ Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver() {
 
 Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Window_Driver(w);
+#endif
 #ifdef FLTK_USE_X11
   if (!attempt_wayland()) return new Fl_X11_Window_Driver(w);
 #endif
@@ -140,6 +160,9 @@ Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 
 Fl_Image_Surface_Driver *Fl_Image_Surface_Driver::newImageSurfaceDriver(int w, int h, int high_res, Fl_Offscreen off)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Image_Surface_Driver(w, h, high_res, off);
+#endif
 #ifdef FLTK_USE_X11
   if (!attempt_wayland())
     return new Fl_Xlib_Image_Surface_Driver(w, h, high_res, off);
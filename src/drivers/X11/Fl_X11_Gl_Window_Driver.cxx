@@ -17,6 +17,7 @@
 #include <config.h>
 #if HAVE_GL
 #include <FL/platform.H>
+#include <FL/headless.H>
 #include "../../Fl_Gl_Choice.H"
 #include "../../Fl_Screen_Driver.H"
 #include "Fl_X11_Gl_Window_Driver.H"
@@ -43,6 +44,10 @@ public:
 #ifndef FLTK_USE_WAYLAND
 Fl_Gl_Window_Driver *Fl_Gl_Window_Driver::newGlWindowDriver(Fl_Gl_Window *w)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend())
+    Fl::fatal("OpenGL windows are not supported by the headless backend");
+#endif
   return new Fl_X11_Gl_Window_Driver(w);
 }
 #endif
@@ -27,16 +27,30 @@
 #include "Fl_X11_Window_Driver.H"
 #include "../Xlib/Fl_Xlib_Image_Surface_Driver.H"
 #include "../Base/Fl_Base_Pen_Events.H"
+#if FLTK_USE_HEADLESS
+#  include <FL/headless.H>
+#  include "../Headless/Fl_Headless_Copy_Surface_Driver.H"
+#  include "../Headless/Fl_Headless_Graphics_Driver.H"
+#  include "../Headless/Fl_Headless_Image_Surface_Driver.H"
+#  include "../Headless/Fl_Headless_Screen_Driver.H"
+#  include "../Headless/Fl_Headless_Window_Driver.H"
+#endif
 
 
 Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int h)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Copy_Surface_Driver(w, h);
+#endif
   return new Fl_Xlib_Copy_Surface_Driver(w, h);
 }
 
 
 Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver()
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Graphics_Driver();
+#endif
 #if FLTK_USE_CAIRO
   return new Fl_X11_Cairo_Graphics_Driver();
 #else
@@ -47,6 +61,9 @@ Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver()
 
 Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver()
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Screen_Driver();
+#endif
   Fl_X11_Screen_Driver *d = new Fl_X11_Screen_Driver();
 #if USE_XFT || FLTK_USE_CAIRO
   for (int i = 0;  i < MAX_SCREENS; i++) d->screens[i].scale = 1;
@@ -66,12 +83,18 @@ Fl_System_Driver *Fl_System_Driver::newSystemDriver()
 
 Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Window_Driver(w);
+#endif
   return new Fl_X11_Window_Driver(w);
 }
 
 
 Fl_Image_Surface_Driver *Fl_Image_Surface_Driver::newImageSurfaceDriver(int w, int h, int high_res, Fl_Offscreen off)
 {
+#if FLTK_USE_HEADLESS
+  if (fl_headless_backend()) return new Fl_Headless_Image_Surface_Driver(w, h, high_res, off);
+#endif
   return new Fl_Xlib_Image_Surface_Driver(w, h, high_res, off);
 }
 
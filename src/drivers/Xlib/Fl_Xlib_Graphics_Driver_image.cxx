@@ -751,6 +751,18 @@ void Fl_Xlib_Graphics_Driver::cache(Fl_RGB_Image *img) {
   *pw = img->data_w();
   *ph = img->data_h();
   *Fl_Graphics_Driver::id(img) = (fl_uintptr_t)off;
+#if HAVE_XRENDER
+  if (depth & FL_IMAGE_WITH_ALPHA) {
+    // keep an ARGB32 picture of the pixmap so that drawing the image only
+    // composites it with the destination
+    XRenderPictureAttributes srcattr;
+    memset(&srcattr, 0, sizeof(XRenderPictureAttributes));
+    srcattr.repeat = RepeatPad;
+    static XRenderPictFormat *fmt32 = XRenderFindStandardFormat(fl_display, PictStandardARGB32);
+    *Fl_Graphics_Driver::mask(img) = (fl_uintptr_t)XRenderCreatePicture(fl_display, (Pixmap)off,
+                                                                       fmt32, CPRepeat, &srcattr);
+  }
+#endif // HAVE_XRENDER
 }
 
 
@@ -801,14 +813,15 @@ void Fl_Xlib_Graphics_Driver::draw_rgb(Fl_RGB_Image *rgb, int XP, int YP, int WP
   scale_and_render_pixmap( *Fl_Graphics_Driver::id(rgb), rgb->d(),
                           rgb->data_w() / double(Wfull), rgb->data_h() / double(Hfull),
                           Xs + this->floor(offset_x_), Ys + this->floor(offset_y_),
-                          Wfull, Hfull);
+                          Wfull, Hfull, *Fl_Graphics_Driver::mask(rgb));
   if (need_clip) pop_clip();
 }
 
 /* Draws with Xrender an Fl_Offscreen with optional scaling and accounting for transparency if necessary.
- XP,YP,WP,HP are in drawing units
+ XP,YP,WP,HP are in drawing units.
+ picture is an Xrender picture of pixmap made by cache(Fl_RGB_Image*), or 0.
  */
-int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int depth, double scale_x, double scale_y, int XP, int YP, int WP, int HP) {
+int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int depth, double scale_x, double scale_y, int XP, int YP, int WP, int HP, fl_uintptr_t picture) {
   bool has_alpha = (depth == 2 || depth == 4);
   if (!has_alpha && scale_x == 1 && scale_y == 1) {
     // Fix for a problem visible under XQuartz with test/device and Fl_Image_Surface:
@@ -824,8 +837,8 @@ int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int de
   static XRenderPictFormat *fmt32 = XRenderFindStandardFormat(fl_display, PictStandardARGB32);
   static XRenderPictFormat *dstfmt = XRenderFindVisualFormat(fl_display, fl_visual->visual);
   srcattr.repeat = RepeatPad;
-  Picture src = XRenderCreatePicture(fl_display, (Pixmap)pixmap, has_alpha ?fmt32:fmt24,
-                                     CPRepeat, &srcattr);
+  Picture src = picture ? (Picture)picture :
+    XRenderCreatePicture(fl_display, (Pixmap)pixmap, has_alpha ?fmt32:fmt24, CPRepeat, &srcattr);
   Picture dst = XRenderCreatePicture(fl_display, fl_window, dstfmt, 0, 0);
   if (!src || !dst) {
     fprintf(stderr, "Failed to create Render pictures (%lu %lu)\n", src, dst);
@@ -843,7 +856,7 @@ int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int de
       { XDoubleToFixed( 0 ),       XDoubleToFixed( 0 ),       XDoubleToFixed( 1 ) }
     }};
     XRenderSetPictureTransform(fl_display, src, &mat);
-    if (Fl_Image::scaling_algorithm() == FL_RGB_SCALING_BILINEAR) {
+    if (Fl_Image::scaling_algorithm() != FL_RGB_SCALING_NEAREST) {
       XRenderSetPictureFilter(fl_display, src, FilterBilinear, 0, 0);
       // A note at  https://www.talisman.org/~erlkonig/misc/x11-composite-tutorial/ :
       // "When you use a filter you'll probably want to use PictOpOver as the render op,
@@ -851,11 +864,22 @@ int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int de
       // the edges may end up having alpha values after the filter has been applied."
       // suggests this is necessary :
       has_alpha = true;
+    } else if (picture) {
+      XRenderSetPictureFilter(fl_display, src, FilterNearest, 0, 0);
     }
+  } else if (picture) {
+    // the cached picture keeps the transform and filter of its previous drawing
+    XTransform identity = {{
+      { XDoubleToFixed( 1 ), XDoubleToFixed( 0 ), XDoubleToFixed( 0 ) },
+      { XDoubleToFixed( 0 ), XDoubleToFixed( 1 ), XDoubleToFixed( 0 ) },
+      { XDoubleToFixed( 0 ), XDoubleToFixed( 0 ), XDoubleToFixed( 1 ) }
+    }};
+    XRenderSetPictureTransform(fl_display, src, &identity);
+    XRenderSetPictureFilter(fl_display, src, FilterNearest, 0, 0);
   }
   XRenderComposite(fl_display, (has_alpha ? PictOpOver : PictOpSrc), src, None, dst, 0, 0, 0, 0,
                    XP, YP, WP, HP);
-  XRenderFreePicture(fl_display, src);
+  if (!picture) XRenderFreePicture(fl_display, src);
   XRenderFreePicture(fl_display, dst);
   return 1;
 }
@@ -864,6 +888,12 @@ int Fl_Xlib_Graphics_Driver::scale_and_render_pixmap(Fl_Offscreen pixmap, int de
 
 void Fl_Xlib_Graphics_Driver::uncache(Fl_RGB_Image*, fl_uintptr_t &id_, fl_uintptr_t &mask_)
 {
+#if HAVE_XRENDER
+  if (mask_) {
+    XRenderFreePicture(fl_display, (Picture)mask_);
+    mask_ = 0;
+  }
+#endif // HAVE_XRENDER
   if (id_) {
     XFreePixmap(fl_display, (Pixmap)id_);
     id_ = 0;
@@ -0,0 +1,262 @@
+//
+// Box image cache for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// The scheme box types (gtk, gleam, plastic and oxy) draw their gradients
+// with one line per row or column of pixels. The functions in this file
+// keep pre-rendered copies of such boxes as Fl_RGB_Image objects so a box
+// that was drawn once with a given size, color and scale factor is later
+// drawn with a single image operation which, in turn, uses the graphics
+// driver's own image cache.
+//
+// The box is rendered twice into an Fl_Image_Surface, over a black and over
+// a white background: pixels the box drawing function did not touch differ
+// by 255 between both renderings, whereas opaque pixels are identical, which
+// gives the transparency of each pixel, including antialiased edges.
+
+#include "fl_box_cache.h"
+#include <FL/Fl.H>
+#include <FL/Fl_Device.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/fl_draw.H>
+
+#include <list>
+#include <map>
+
+namespace {
+
+struct Box_Key {
+  Fl_Box_Draw_F *draw;
+  const Fl_Graphics_Driver *driver;
+  int w, h;
+  unsigned rgb;     // RGB value of the box color
+  int active;       // Fl::draw_box_active()
+  int scale;        // integral scale factor of the driver
+
+  bool operator<(const Box_Key &k) const {
+    if (draw != k.draw) return draw < k.draw;
+    if (driver != k.driver) return driver < k.driver;
+    if (w != k.w) return w < k.w;
+    if (h != k.h) return h < k.h;
+    if (rgb != k.rgb) return rgb < k.rgb;
+    if (active != k.active) return active < k.active;
+    return scale < k.scale;
+  }
+};
+
+struct Box_Entry {
+  Box_Key key;
+  Fl_RGB_Image *image;
+  size_t bytes;
+};
+
+typedef std::list<Box_Entry> Box_List; // most recently used first
+typedef std::map<Box_Key, Box_List::iterator> Box_Map;
+
+Box_List lru;
+Box_Map box_index;
+size_t cache_limit = 8 * 1024 * 1024; // bytes
+size_t cache_bytes = 0;
+unsigned long cache_hits = 0;
+unsigned long cache_misses = 0;
+
+void evict(size_t needed) {
+  while (!lru.empty() && cache_bytes + needed > cache_limit) {
+    Box_Entry &e = lru.back();
+    cache_bytes -= e.bytes;
+    box_index.erase(e.key);
+    delete e.image;
+    lru.pop_back();
+  }
+}
+
+// Draws the box into an offscreen twice and combines both results into
+// an RGBA image, or an RGB image if the box turns out to be fully opaque.
+Fl_RGB_Image *render_box(Fl_Box_Draw_F *draw, int w, int h, Fl_Color c) {
+  Fl_Image_Surface *surf = new Fl_Image_Surface(w, h, 1);
+  Fl_Surface_Device::push_current(surf);
+  fl_color(0, 0, 0);
+  fl_rectf(0, 0, w, h);
+  draw(0, 0, w, h, c);
+  Fl_RGB_Image *on_black = surf->image();
+  fl_color(255, 255, 255);
+  fl_rectf(0, 0, w, h);
+  draw(0, 0, w, h, c);
+  Fl_RGB_Image *on_white = surf->image();
+  Fl_Surface_Device::pop_current();
+  delete surf;
+
+  int W = on_black->data_w(), H = on_black->data_h();
+  int ldb = on_black->ld() ? on_black->ld() : W * on_black->d();
+  int ldw = on_white->ld() ? on_white->ld() : W * on_white->d();
+  int db = on_black->d(), dw = on_white->d();
+  uchar *rgba = new uchar[W * H * 4];
+  uchar *q = rgba;
+  bool opaque = true;
+  for (int j = 0; j < H; j++) {
+    const uchar *b = on_black->array + j * ldb;
+    const uchar *wh = on_white->array + j * ldw;
+    for (int i = 0; i < W; i++, b += db, wh += dw) {
+      int diff = 0;
+      for (int k = 0; k < 3; k++) {
+        if (wh[k] - b[k] > diff) diff = wh[k] - b[k];
+      }
+      int a = 255 - diff;
+      if (a == 255) {
+        q[0] = b[0]; q[1] = b[1]; q[2] = b[2];
+      } else if (a == 0) {
+        q[0] = q[1] = q[2] = 0;
+      } else { // over black, the pixel value is the color premultiplied by alpha
+        for (int k = 0; k < 3; k++) {
+          int v = (b[k] * 255 + a / 2) / a;
+          q[k] = uchar(v > 255 ? 255 : v);
+        }
+      }
+      q[3] = uchar(a);
+      if (a != 255) opaque = false;
+      q += 4;
+    }
+  }
+  delete on_black;
+  delete on_white;
+
+  Fl_RGB_Image *img;
+  if (opaque) { // drop the alpha channel, opaque images are drawn faster
+    uchar *rgb = new uchar[W * H * 3];
+    for (int i = 0; i < W * H; i++) {
+      rgb[3*i] = rgba[4*i]; rgb[3*i+1] = rgba[4*i+1]; rgb[3*i+2] = rgba[4*i+2];
+    }
+    delete[] rgba;
+    img = new Fl_RGB_Image(rgb, W, H, 3);
+  } else {
+    img = new Fl_RGB_Image(rgba, W, H, 4);
+  }
+  img->alloc_array = 1;
+  img->scale(w, h, 0, 1);
+  return img;
+}
+
+} // namespace
+
+
+void fl_cached_box(Fl_Box_Draw_F *draw, int x, int y, int w, int h, Fl_Color c) {
+  if (w < 1 || h < 1) return;
+  // Only drawings to the display are cached: printers and image surfaces
+  // keep the vector output of the box drawing function.
+  if (!cache_limit || Fl_Surface_Device::surface() != Fl_Display_Device::display_device()) {
+    draw(x, y, w, h, c);
+    return;
+  }
+  // A box drawn at a fractional scale factor is not pixel-identical to an
+  // image of it drawn elsewhere, because line positions are rounded after
+  // scaling the box origin.
+  float s = fl_graphics_driver->scale();
+  int is = int(s);
+  if (s != float(is)) {
+    draw(x, y, w, h, c);
+    return;
+  }
+  size_t bytes = size_t(w) * is * size_t(h) * is * 4;
+  if (bytes > cache_limit / 8) { // too large to be worth keeping
+    draw(x, y, w, h, c);
+    return;
+  }
+
+  Box_Key key;
+  key.draw = draw;
+  key.driver = fl_graphics_driver;
+  key.w = w;
+  key.h = h;
+  key.rgb = Fl::get_color(c);
+  key.active = Fl::draw_box_active();
+  key.scale = is;
+
+  Box_Map::iterator it = box_index.find(key);
+  if (it != box_index.end()) {
+    cache_hits++;
+    lru.splice(lru.begin(), lru, it->second); // mark as most recently used
+    it->second->image->draw(x, y);
+    return;
+  }
+
+  cache_misses++;
+  Fl_RGB_Image *img = render_box(draw, w, h, c);
+  bytes = size_t(img->data_w()) * img->data_h() * img->d();
+  evict(bytes);
+  Box_Entry e = { key, img, bytes };
+  lru.push_front(e);
+  box_index[key] = lru.begin();
+  cache_bytes += bytes;
+  img->draw(x, y);
+}
+
+
+/** \addtogroup fl_drawings
+ \{ */
+
+/**
+ Sets the memory limit of the box image cache, in bytes.
+
+ The gradient box types of the "gtk", "gleam", "plastic" and "oxy" schemes
+ keep images of the boxes they draw in a window so the same box is drawn
+ faster the next time. Least recently used images are released when the
+ limit is reached. A value of 0 disables the cache. The default is 8 MB.
+ \see fl_box_cache_stats()
+ \since 1.5.0
+ */
+void fl_box_cache_size(size_t bytes) {
+  cache_limit = bytes;
+  evict(0);
+}
+
+/** Returns the memory limit of the box image cache, in bytes.
+ \since 1.5.0
+ */
+size_t fl_box_cache_size() {
+  return cache_limit;
+}
+
+/**
+ Returns usage counters of the box image cache.
+
+ \param[out] hits    number of boxes drawn from the cache
+ \param[out] misses  number of boxes that were rendered and added to the cache
+ \param[out] entries number of images in the cache
+ \param[out] bytes   memory used by these images
+ \since 1.5.0
+ */
+void fl_box_cache_stats(unsigned long &hits, unsigned long &misses, int &entries, size_t &bytes) {
+  hits = cache_hits;
+  misses = cache_misses;
+  entries = (int)lru.size();
+  bytes = cache_bytes;
+}
+
+/**
+ Releases all images of the box image cache.
+
+ FLTK calls this when a color of the colormap or a scheme parameter changes,
+ because cached boxes may have been drawn with the previous colors.
+ \since 1.5.0
+ */
+void fl_box_cache_clear() {
+  size_t limit = cache_limit;
+  cache_limit = 0;
+  evict(0);
+  cache_limit = limit;
+}
+
+/** \} */
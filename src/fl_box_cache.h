@@ -0,0 +1,31 @@
+//
+// Box image cache for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#ifndef fl_box_cache_h
+#define fl_box_cache_h
+
+#include <FL/Fl.H>
+
+// Draws a box with the box drawing function \p draw, or with a copy of its
+// output cached by an earlier call with the same function, size, color,
+// active state and scale factor.
+//
+// This is used by the scheme box types that draw gradients line by line.
+// The cache is only used when drawing to the display.
+
+extern void fl_cached_box(Fl_Box_Draw_F *draw, int x, int y, int w, int h, Fl_Color c);
+
+#endif // fl_box_cache_h
@@ -24,6 +24,7 @@
 #include <FL/Fl.H>
 #include <FL/Fl_Device.H>
 #include <FL/Fl_Graphics_Driver.H>
+#include <FL/fl_draw.H>
 
 // fl_cmap needs to be defined globally (here) and is used in the device
 // specific graphics drivers. It is required to 'FL_EXPORT' this symbol
@@ -83,12 +84,14 @@ void Fl::set_color(Fl_Color i, uchar red, uchar green, uchar blue, uchar alpha)
 void Fl::set_color(Fl_Color i, unsigned c)
 {
   Fl_Graphics_Driver::default_driver().set_color(i, c);
+  fl_box_cache_clear(); // cached boxes may use the previous color
 }
 
 
 void Fl::free_color(Fl_Color i, int overlay)
 {
   Fl_Graphics_Driver::default_driver().free_color(i, overlay);
+  fl_box_cache_clear();
 }
 
 
@@ -25,6 +25,7 @@
 
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
+#include "fl_box_cache.h"
 
 /*
   Implementation notes:
@@ -140,12 +141,12 @@ void fl_gleam_up_frame(int x, int y, int w, int h, Fl_Color c) {
   frame_rect_up(x, y, w, h, c, fl_color_average(c, FL_WHITE, .25f), .55f, .05f);
 }
 
-void fl_gleam_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gleam_up_box(int x, int y, int w, int h, Fl_Color c) {
   shade_rect_top_bottom_up(x, y, w, h, c, .15f);
   frame_rect_up(x, y, w, h, c, fl_color_average(c, FL_WHITE, .05f), .15f, .05f);
 }
 
-void fl_gleam_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gleam_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
   shade_rect_top_bottom_up(x, y, w, h, c, .25f);
   frame_rect_up(x, y, w, h, c, fl_color_average(c, FL_WHITE, .45f), .25f, .15f);
 }
@@ -154,12 +155,30 @@ void fl_gleam_down_frame(int x, int y, int w, int h, Fl_Color c) {
   frame_rect_down(x, y, w, h, fl_darker(c), fl_darker(c), .25f, .95f);
 }
 
-void fl_gleam_down_box(int x, int y, int w, int h, Fl_Color c) {
+static void gleam_down_box(int x, int y, int w, int h, Fl_Color c) {
   shade_rect_top_bottom_down(x, y, w, h, c, .65f);
   frame_rect_down(x, y, w, h, c, fl_color_average(c, FL_BLACK, .05f), .05f, .95f);
 }
 
-void fl_gleam_thin_down_box(int x, int y, int w, int h, Fl_Color c) {
+static void gleam_thin_down_box(int x, int y, int w, int h, Fl_Color c) {
   shade_rect_top_bottom_down(x, y, w, h, c, .85f);
   frame_rect_down(x, y, w, h, c, fl_color_average(c, FL_BLACK, .45f), .35f, 0.85f);
 }
+
+// The shaded box types are drawn through the box image cache
+
+void fl_gleam_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gleam_up_box, x, y, w, h, c);
+}
+
+void fl_gleam_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gleam_thin_up_box, x, y, w, h, c);
+}
+
+void fl_gleam_down_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gleam_down_box, x, y, w, h, c);
+}
+
+void fl_gleam_thin_down_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gleam_thin_down_box, x, y, w, h, c);
+}
@@ -23,6 +23,7 @@
 
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
+#include "fl_box_cache.h"
 
 static void gtk_color(Fl_Color c) {
   Fl::set_box_color(c);
@@ -47,7 +48,7 @@ void fl_gtk_up_frame(int x, int y, int w, int h, Fl_Color c) {
 }
 
 
-void fl_gtk_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_up_box(int x, int y, int w, int h, Fl_Color c) {
   fl_gtk_up_frame(x, y, w, h, c);
 
   gtk_color(fl_color_average(FL_WHITE, c, 0.4f));
@@ -110,7 +111,7 @@ void fl_gtk_thin_up_frame(int x, int y, int w, int h, Fl_Color c) {
 }
 
 
-void fl_gtk_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
   fl_gtk_thin_up_frame(x, y, w, h, c);
 
   gtk_color(fl_color_average(FL_WHITE, c, 0.4f));
@@ -199,7 +200,7 @@ static void draw(int which, int x,int y,int w,int h, int inset)
   }
 }
 
-void fl_gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
   gtk_color(c);
   draw(FILL,        x,   y, w,   h, 2);
 
@@ -231,7 +232,7 @@ void fl_gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
 }
 
 
-void fl_gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
   gtk_color(c);
   draw(FILL,        x,   y, w,   h, 2);
 
@@ -258,7 +259,7 @@ void fl_gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
 
 #else
 
-void fl_gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
   gtk_color(c);
   fl_pie(x, y, w, h, 0.0, 360.0);
   gtk_color(fl_color_average(FL_WHITE, c, 0.5f));
@@ -270,7 +271,7 @@ void fl_gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
 }
 
 
-void fl_gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
+static void gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
   gtk_color(c);
   fl_pie(x, y, w, h, 0.0, 360.0);
   gtk_color(fl_color_average(FL_BLACK, c, 0.2));
@@ -281,4 +282,22 @@ void fl_gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
 
 #endif
 
+// The box types with gradients are drawn through the box image cache
+
+void fl_gtk_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gtk_up_box, x, y, w, h, c);
+}
+
+void fl_gtk_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gtk_thin_up_box, x, y, w, h, c);
+}
+
+void fl_gtk_round_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gtk_round_up_box, x, y, w, h, c);
+}
+
+void fl_gtk_round_down_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(gtk_round_down_box, x, y, w, h, c);
+}
+
 extern void fl_round_focus(Fl_Boxtype bt, int x, int y, int w, int h, Fl_Color fg, Fl_Color bg);
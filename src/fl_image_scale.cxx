@@ -0,0 +1,579 @@
+//
+// RGB image scaling for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// The bilinear filter is separable: each source row is interpolated
+// horizontally once into a row of 16-bit values, and two such rows are
+// interpolated vertically for each destination row. Positions and weights
+// are fixed-point numbers with 7 fractional bits. The vertical pass and
+// the 2:1 reductions work on contiguous bytes and use SSE2 where the
+// compiler supports it, with a scalar version for all other processors.
+//
+// The area and Lanczos filters are separable as well, with a table of the
+// weights of the source pixels for each destination column and row that
+// is calculated once per image. Source rows are filtered horizontally
+// into a ring of rows from which the vertical pass takes its input.
+//
+// Images with more than a few hundred kilobytes are scaled by a small pool
+// of threads. The pool is created when it is first used and its threads
+// wait for work until the program exits. Several threads may scale images
+// at the same time, e.g. the threads of Fl_Shared_Image::get_async().
+
+#include <config.h>
+#include "fl_image_scale.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define FL_SCALE_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+#if defined(HAVE_PTHREAD) || defined(_WIN32)
+#  define FL_SCALE_THREADS 1
+#  include <atomic>
+#  include <condition_variable>
+#  include <deque>
+#  include <memory>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace {
+
+const int BITS = 7;             // fractional bits of positions and weights
+const int ONE = 1 << BITS;
+
+// Images are split between threads so that each one writes at least this many bytes
+const long min_bytes_per_thread = 256 * 1024;
+
+#if FL_SCALE_THREADS
+
+// A range of rows to be processed by the calling thread and some pool threads
+struct Batch {
+  const std::function<void(int, int)> *fn;
+  int rows, chunk;
+  std::atomic<int> next;        // first row not handed out yet
+  std::atomic<int> done;        // number of rows finished
+  std::mutex mutex;
+  std::condition_variable cond;
+
+  void run() {
+    for (;;) {
+      int y0 = next.fetch_add(chunk);
+      if (y0 >= rows) return;
+      int y1 = std::min(y0 + chunk, rows);
+      (*fn)(y0, y1);
+      if (done.fetch_add(y1 - y0) + (y1 - y0) == rows) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cond.notify_all();
+      }
+    }
+  }
+};
+
+struct Pool {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::shared_ptr<Batch> > queue;
+  int threads;
+};
+
+Pool *pool = 0;
+std::once_flag pool_once;
+
+void pool_worker() {
+  for (;;) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(pool->mutex);
+      pool->cond.wait(lock, [] { return !pool->queue.empty(); });
+      batch = pool->queue.front();
+      pool->queue.pop_front();
+    }
+    batch->run();
+  }
+}
+
+void pool_create() {
+  pool = new Pool;
+  unsigned n = std::thread::hardware_concurrency();
+  if (n > 8) n = 8;
+  pool->threads = n > 1 ? int(n - 1) : 0; // the calling thread works as well
+  for (int i = 0; i < pool->threads; i++)
+    std::thread(pool_worker).detach();
+}
+
+#endif // FL_SCALE_THREADS
+
+// Calls fn(y0, y1) for ranges of rows that cover rows 0 to rows-1, using
+// several threads if the image is large enough. Returns when all rows are done.
+void parallel_rows(int rows, long bytes_per_row, const std::function<void(int, int)> &fn) {
+#if FL_SCALE_THREADS
+  long n = rows * bytes_per_row / min_bytes_per_thread;
+  if (n > 1) {
+    std::call_once(pool_once, pool_create);
+    if (n > pool->threads + 1) n = pool->threads + 1;
+  }
+  if (n > 1) {
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->fn = &fn;
+    batch->rows = rows;
+    batch->chunk = std::max(1, int(rows / (n * 4)));
+    batch->next = 0;
+    batch->done = 0;
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      for (long i = 1; i < n; i++)
+        pool->queue.push_back(batch);
+    }
+    pool->cond.notify_all();
+    batch->run();
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->cond.wait(lock, [&] { return batch->done == rows; });
+    return;
+  }
+#endif // FL_SCALE_THREADS
+  fn(0, rows);
+}
+
+// The positions of the nearest source pixels, as calculated by the
+// Bresenham algorithm used by earlier versions of Fl_RGB_Image::copy()
+void nearest_positions(int n, int N, int *pos) {
+  int mod = n % N, step = n / N, err = N, p = 0;
+  for (int i = 0; i < N; i++) {
+    pos[i] = p;
+    p += step;
+    err -= mod;
+    if (err <= 0) {
+      err += N;
+      p++;
+    }
+  }
+}
+
+template <int D>
+void nearest_rows(const uchar *src, long sld, const int *xoff, const int *ys,
+                  uchar *dst, int W, int y0, int y1) {
+  for (int y = y0; y < y1; y++) {
+    uchar *o = dst + long(y) * W * D;
+    if (y > y0 && ys[y] == ys[y - 1]) { // same source row as the row above
+      memcpy(o, o - long(W) * D, size_t(W) * D);
+      continue;
+    }
+    const uchar *s = src + long(ys[y]) * sld;
+    for (int x = 0; x < W; x++, o += D) {
+      const uchar *p = s + xoff[x];
+      for (int c = 0; c < D; c++) o[c] = p[c];
+    }
+  }
+}
+
+// Fixed-point position of destination pixel i of N in a row of n source
+// pixels, mapping the image like earlier versions: (n - 1) / N per pixel
+void bilinear_positions(int n, int N, int step, int *off0, int *off1, short *frac) {
+  for (int i = 0; i < N; i++) {
+    long long p = (long long)i * (n - 1) * ONE / N;
+    int s = int(p >> BITS);
+    off0[i] = s * step;
+    off1[i] = std::min(s + 1, n - 1) * step;
+    frac[i] = short(p & (ONE - 1));
+  }
+}
+
+// v / 255 for 0 <= v <= 255 * 255
+inline int div255(int v) {
+  return (v + 1 + (v >> 8)) >> 8;
+}
+
+// Interpolates a source row horizontally, colors of RGBA pixels are
+// multiplied by alpha.
+template <int D>
+void bilinear_row(const uchar *s, const int *off0, const int *off1, const short *frac,
+                  short *out, int W) {
+  for (int x = 0; x < W; x++, out += D) {
+    const uchar *a = s + off0[x], *b = s + off1[x];
+    int f = frac[x], g = ONE - f;
+    if (D == 4) {
+      int aa = a[3], ba = b[3];
+      for (int c = 0; c < 3; c++)
+        out[c] = short(div255(a[c] * aa) * g + div255(b[c] * ba) * f);
+      out[3] = short(aa * g + ba * f);
+    } else {
+      for (int c = 0; c < D; c++)
+        out[c] = short(a[c] * g + b[c] * f);
+    }
+  }
+}
+
+// Interpolates n values of two rows vertically: (h0 * (ONE - f) + h1 * f) / ONE^2
+void bilinear_blend(const short *h0, const short *h1, int f, uchar *out, int n) {
+  const int round = 1 << (2 * BITS - 1);
+  int i = 0;
+#if FL_SCALE_SSE2
+  const __m128i w = _mm_set1_epi32((f << 16) | (ONE - f));
+  const __m128i r = _mm_set1_epi32(round);
+  for (; i + 16 <= n; i += 16) {
+    __m128i v[2];
+    for (int k = 0; k < 2; k++) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(h0 + i + 8 * k));
+      __m128i b = _mm_loadu_si128((const __m128i *)(h1 + i + 8 * k));
+      __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w);
+      __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w);
+      lo = _mm_srai_epi32(_mm_add_epi32(lo, r), 2 * BITS);
+      hi = _mm_srai_epi32(_mm_add_epi32(hi, r), 2 * BITS);
+      v[k] = _mm_packs_epi32(lo, hi);
+    }
+    _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(v[0], v[1]));
+  }
+#endif
+  for (; i < n; i++)
+    out[i] = uchar((h0[i] * (ONE - f) + h1[i] * f + round) >> (2 * BITS));
+}
+
+// Divides the colors of n RGBA pixels by alpha
+void unpremultiply(uchar *p, int n) {
+  static const std::vector<int> factor = [] {
+    std::vector<int> t(256, 0);
+    for (int a = 1; a < 256; a++) t[a] = (255 << 16) / a;
+    return t;
+  }();
+  for (int i = 0; i < n; i++, p += 4) {
+    int a = p[3];
+    if (!a || a == 255) continue;
+    int f = factor[a];
+    for (int c = 0; c < 3; c++) {
+      int v = (p[c] * f + 32768) >> 16;
+      p[c] = uchar(v > 255 ? 255 : v);
+    }
+  }
+}
+
+// Fixed-point bits of filter weights, and the fractional bits of the
+// horizontally filtered values
+const int WBITS = 14;
+const int HBITS = 6;
+
+// The source pixels and their weights for each destination pixel of one axis
+struct Filter_Table {
+  std::vector<int> first;       // first source pixel
+  std::vector<int> count;       // number of source pixels
+  std::vector<short> weight;    // count weights per destination pixel, at index i * taps
+  int taps;                     // largest count
+
+  // converts the weights in w[first - lo ...] of destination pixel i to fixed-point
+  void set(int i, int lo, const std::vector<double> &w, int n) {
+    // trailing zero weights are dropped, leading ones are kept so that the
+    // first source pixel never decreases from one destination pixel to the next
+    int a = 0, b = n - 1;
+    while (b > a && w[b] == 0) b--;
+    double sum = 0;
+    for (int k = a; k <= b; k++) sum += w[k];
+    first[i] = lo + a;
+    count[i] = b - a + 1;
+    short *o = &weight[size_t(i) * taps];
+    int total = 0, big = 0;
+    for (int k = a; k <= b; k++) {
+      o[k - a] = short(floor(w[k] / sum * (1 << WBITS) + 0.5));
+      total += o[k - a];
+      if (o[k - a] > o[big]) big = k - a;
+    }
+    o[big] += short((1 << WBITS) - total); // the weights must add up to 1 exactly
+  }
+};
+
+// Source pixel i of n covers [i, i + 1). Destination pixel i of N covers
+// [i * n / N, (i + 1) * n / N), each source pixel is weighted by the overlap.
+void area_table(int n, int N, Filter_Table &t) {
+  double s = double(n) / N;
+  t.taps = int(ceil(s)) + 1;
+  t.first.resize(N);
+  t.count.resize(N);
+  t.weight.assign(size_t(N) * t.taps, 0);
+  std::vector<double> w(t.taps);
+  for (int i = 0; i < N; i++) {
+    double a = i * s, b = std::min((i + 1) * s, double(n));
+    int lo = int(a);
+    for (int k = 0; k < t.taps; k++) {
+      double o = std::min(b, double(lo + k + 1)) - std::max(a, double(lo + k));
+      w[k] = (o > 0 && lo + k < n) ? o : 0;
+    }
+    t.set(i, lo, w, t.taps);
+  }
+}
+
+double lanczos3(double x) {
+  if (x == 0) return 1;
+  if (x <= -3 || x >= 3) return 0;
+  const double pi = 3.14159265358979323846;
+  return 3 * sin(pi * x) * sin(pi * x / 3) / (pi * pi * x * x);
+}
+
+// The filter is centered on the center of each destination pixel. When the
+// image is reduced it is widened by the reduction factor. Source pixels
+// beyond the edges are replaced by the edge pixels.
+void lanczos_table(int n, int N, Filter_Table &t) {
+  double s = double(n) / N;
+  double fs = std::max(s, 1.0);
+  double support = 3 * fs;
+  t.taps = int(ceil(2 * support)) + 1;
+  t.first.resize(N);
+  t.count.resize(N);
+  t.weight.assign(size_t(N) * t.taps, 0);
+  std::vector<double> w;
+  for (int i = 0; i < N; i++) {
+    double center = (i + 0.5) * s - 0.5;
+    int lo = int(ceil(center - support)), hi = int(floor(center + support));
+    int clo = std::max(lo, 0), chi = std::min(hi, n - 1);
+    if (clo > chi) clo = chi = std::min(std::max(int(floor(center + 0.5)), 0), n - 1);
+    w.assign(chi - clo + 1, 0);
+    for (int j = lo; j <= hi; j++) {
+      int k = std::min(std::max(j, clo), chi) - clo;
+      w[k] += lanczos3((j - center) / fs);
+    }
+    t.set(i, clo, w, int(w.size()));
+  }
+}
+
+// Filters a source row horizontally, colors of RGBA pixels are multiplied by alpha
+template <int D>
+void filter_row(const uchar *s, const Filter_Table &t, short *out, int W) {
+  const short *w = &t.weight[0];
+  for (int x = 0; x < W; x++, out += D, w += t.taps) {
+    const uchar *p = s + t.first[x] * D;
+    int acc[D];
+    for (int c = 0; c < D; c++) acc[c] = 0;
+    for (int k = 0; k < t.count[x]; k++, p += D) {
+      if (D == 4) {
+        int a = p[3];
+        for (int c = 0; c < 3; c++) acc[c] += w[k] * div255(p[c] * a);
+        acc[3] += w[k] * a;
+      } else {
+        for (int c = 0; c < D; c++) acc[c] += w[k] * p[c];
+      }
+    }
+    for (int c = 0; c < D; c++)
+      out[c] = short((acc[c] + (1 << (WBITS - HBITS - 1))) >> (WBITS - HBITS));
+  }
+}
+
+// Scales with the filter tables fx and fy
+void resample(const uchar *src, int sld, int d, uchar *dst, int W, int H,
+              const Filter_Table &fx, const Filter_Table &fy) {
+  const int n = W * d;
+  parallel_rows(H, n, [&](int y0, int y1) {
+    const int size = fy.taps;                   // rows in the ring
+    std::vector<short> ring(size_t(size) * n);  // horizontally filtered source rows
+    std::vector<int> acc(n);
+    int next = -1;                              // next source row to be filtered
+    for (int y = y0; y < y1; y++) {
+      int first = fy.first[y], count = fy.count[y];
+      if (next < first) next = first;
+      for (; next < first + count; next++) {
+        const uchar *s = src + long(next) * sld;
+        short *o = &ring[size_t(next % size) * n];
+        switch (d) {
+          case 1: filter_row<1>(s, fx, o, W); break;
+          case 2: filter_row<2>(s, fx, o, W); break;
+          case 3: filter_row<3>(s, fx, o, W); break;
+          default: filter_row<4>(s, fx, o, W); break;
+        }
+      }
+      std::fill(acc.begin(), acc.end(), 0);
+      const short *w = &fy.weight[size_t(y) * fy.taps];
+      for (int k = 0; k < count; k++) {
+        const short *h = &ring[size_t((first + k) % size) * n];
+        const int wk = w[k];
+        for (int i = 0; i < n; i++) acc[i] += wk * h[i];
+      }
+      uchar *o = dst + long(y) * n;
+      const int round = 1 << (WBITS + HBITS - 1);
+      for (int i = 0; i < n; i++) {
+        int v = (acc[i] + round) >> (WBITS + HBITS);
+        o[i] = uchar(v < 0 ? 0 : v > 255 ? 255 : v);
+      }
+      if (d == 4) {
+        // filters with negative weights can make colors brighter than alpha
+        for (int i = 0; i < n; i += 4)
+          for (int c = 0; c < 3; c++) if (o[i + c] > o[i + 3]) o[i + c] = o[i + 3];
+        unpremultiply(o, W);
+      }
+    }
+  });
+}
+
+// (a + b) / 2 rounded down, for 16 bytes at a time
+#if FL_SCALE_SSE2
+inline __m128i average(__m128i a, __m128i b) {
+  __m128i odd = _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1));
+  return _mm_sub_epi8(_mm_avg_epu8(a, b), odd);
+}
+#endif
+
+// Averages pairs of neighboring pixels of a row of 2 * W pixels
+template <int D>
+void half_row(const uchar *s, uchar *o, int W) {
+  int x = 0;
+#if FL_SCALE_SSE2
+  if (D == 1) {
+    const __m128i mask = _mm_set1_epi16(0xff);
+    for (; x + 16 <= W; x += 16, s += 32, o += 16) {
+      __m128i v[2];
+      for (int k = 0; k < 2; k++) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(s + 16 * k));
+        v[k] = _mm_srli_epi16(_mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8)), 1);
+      }
+      _mm_storeu_si128((__m128i *)o, _mm_packus_epi16(v[0], v[1]));
+    }
+  } else if (D == 2) {
+    for (; x + 8 <= W; x += 8, s += 32, o += 16) {
+      __m128i v[2];
+      for (int k = 0; k < 2; k++) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(s + 16 * k));
+        a = average(a, _mm_srli_epi32(a, 16)); // result in the low half of each pair
+        v[k] = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+      }
+      _mm_storeu_si128((__m128i *)o, _mm_packs_epi32(v[0], v[1]));
+    }
+  } else if (D == 4) {
+    for (; x + 4 <= W; x += 4, s += 32, o += 16) {
+      __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)s));
+      __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(s + 16)));
+      __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+      _mm_storeu_si128((__m128i *)o, average(even, odd));
+    }
+  }
+#endif
+  for (; x < W; x++, s += 2 * D) {
+    for (int c = 0; c < D; c++)
+      *o++ = uchar((unsigned(s[c]) + unsigned(s[c + D])) >> 1);
+  }
+}
+
+// Averages n bytes of two rows
+void half_rows(const uchar *s0, const uchar *s1, uchar *o, int n) {
+  int i = 0;
+#if FL_SCALE_SSE2
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(s0 + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(s1 + i));
+    _mm_storeu_si128((__m128i *)(o + i), average(a, b));
+  }
+#endif
+  for (; i < n; i++)
+    o[i] = uchar((unsigned(s0[i]) + unsigned(s1[i])) >> 1);
+}
+
+} // namespace
+
+
+void fl_scale_nearest(const uchar *src, int sw, int sh, int sld, int d,
+                      uchar *dst, int W, int H) {
+  std::vector<int> xoff(W), ys(H);
+  nearest_positions(sw, W, &xoff[0]);
+  for (int x = 0; x < W; x++) xoff[x] *= d;
+  nearest_positions(sh, H, &ys[0]);
+  parallel_rows(H, long(W) * d, [&](int y0, int y1) {
+    switch (d) {
+      case 1: nearest_rows<1>(src, sld, &xoff[0], &ys[0], dst, W, y0, y1); break;
+      case 2: nearest_rows<2>(src, sld, &xoff[0], &ys[0], dst, W, y0, y1); break;
+      case 3: nearest_rows<3>(src, sld, &xoff[0], &ys[0], dst, W, y0, y1); break;
+      default: nearest_rows<4>(src, sld, &xoff[0], &ys[0], dst, W, y0, y1); break;
+    }
+  });
+}
+
+void fl_scale_bilinear(const uchar *src, int sw, int sh, int sld, int d,
+                       uchar *dst, int W, int H) {
+  std::vector<int> x0(W), x1(W), y0(H), y1(H);
+  std::vector<short> fx(W), fy(H);
+  bilinear_positions(sw, W, d, &x0[0], &x1[0], &fx[0]);
+  bilinear_positions(sh, H, 1, &y0[0], &y1[0], &fy[0]);
+  const int n = W * d;
+  parallel_rows(H, n, [&](int first, int last) {
+    std::vector<short> buf0(n), buf1(n);  // interpolated source rows
+    int row0 = -1, row1 = -1;             // their row numbers
+    for (int y = first; y < last; y++) {
+      int need[2] = { y0[y], fy[y] ? y1[y] : -1 };
+      if (row0 != need[0] && row1 == need[0]) {
+        buf0.swap(buf1);
+        std::swap(row0, row1);
+      }
+      for (int k = 0; k < 2; k++) {
+        int &row = k ? row1 : row0;
+        if (need[k] < 0 || row == need[k]) continue;
+        const uchar *s = src + long(need[k]) * sld;
+        short *o = k ? &buf1[0] : &buf0[0];
+        switch (d) {
+          case 1: bilinear_row<1>(s, &x0[0], &x1[0], &fx[0], o, W); break;
+          case 2: bilinear_row<2>(s, &x0[0], &x1[0], &fx[0], o, W); break;
+          case 3: bilinear_row<3>(s, &x0[0], &x1[0], &fx[0], o, W); break;
+          default: bilinear_row<4>(s, &x0[0], &x1[0], &fx[0], o, W); break;
+        }
+        row = need[k];
+      }
+      uchar *o = dst + long(y) * n;
+      bilinear_blend(&buf0[0], fy[y] ? &buf1[0] : &buf0[0], fy[y], o, n);
+      if (d == 4) unpremultiply(o, W);
+    }
+  });
+}
+
+void fl_scale_area(const uchar *src, int sw, int sh, int sld, int d,
+                   uchar *dst, int W, int H) {
+  Filter_Table fx, fy;
+  area_table(sw, W, fx);
+  area_table(sh, H, fy);
+  resample(src, sld, d, dst, W, H, fx, fy);
+}
+
+void fl_scale_lanczos(const uchar *src, int sw, int sh, int sld, int d,
+                      uchar *dst, int W, int H) {
+  Filter_Table fx, fy;
+  lanczos_table(sw, W, fx);
+  lanczos_table(sh, H, fy);
+  resample(src, sld, d, dst, W, H, fx, fy);
+}
+
+void fl_scale_down_2h(const uchar *src, int sw, int sh, int sld, int d, uchar *dst) {
+  const int W = sw / 2;
+  parallel_rows(sh, long(W) * d, [&](int first, int last) {
+    for (int y = first; y < last; y++) {
+      const uchar *s = src + long(y) * sld;
+      uchar *o = dst + long(y) * W * d;
+      switch (d) {
+        case 1: half_row<1>(s, o, W); break;
+        case 2: half_row<2>(s, o, W); break;
+        case 3: half_row<3>(s, o, W); break;
+        default: half_row<4>(s, o, W); break;
+      }
+    }
+  });
+}
+
+void fl_scale_down_2v(const uchar *src, int sw, int sh, int sld, int d, uchar *dst) {
+  const int n = sw * d;
+  parallel_rows(sh / 2, n, [&](int first, int last) {
+    for (int y = first; y < last; y++) {
+      const uchar *s = src + 2L * y * sld;
+      half_rows(s, s + sld, dst + long(y) * n, n);
+    }
+  });
+}
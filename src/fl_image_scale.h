@@ -0,0 +1,54 @@
+//
+// RGB image scaling for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#ifndef fl_image_scale_h
+#define fl_image_scale_h
+
+#include <FL/fl_types.h>
+
+// Scaling kernels used by Fl_RGB_Image::copy(). All functions read an image
+// of sw x sh pixels with d bytes per pixel (1 to 4) and sld bytes per row,
+// and write a W x H image with W * d bytes per row. Large images are scaled
+// by several threads, each one working on a range of rows.
+
+// Copies the nearest source pixel to each pixel of the W x H image.
+extern void fl_scale_nearest(const uchar *src, int sw, int sh, int sld, int d,
+                             uchar *dst, int W, int H);
+
+// Interpolates between the four nearest source pixels. Colors of images with
+// alpha channel (d == 4) are weighted by alpha.
+extern void fl_scale_bilinear(const uchar *src, int sw, int sh, int sld, int d,
+                              uchar *dst, int W, int H);
+
+// Averages all source pixels covered by each destination pixel, weighted
+// by the covered area. Colors of images with alpha channel are weighted by alpha.
+extern void fl_scale_area(const uchar *src, int sw, int sh, int sld, int d,
+                          uchar *dst, int W, int H);
+
+// Interpolates with a Lanczos filter with 3 lobes, stretched to cover all
+// source pixels of each destination pixel when the image is reduced.
+extern void fl_scale_lanczos(const uchar *src, int sw, int sh, int sld, int d,
+                             uchar *dst, int W, int H);
+
+// Averages pairs of source pixels horizontally, W = sw / 2 and H = sh.
+extern void fl_scale_down_2h(const uchar *src, int sw, int sh, int sld, int d,
+                             uchar *dst);
+
+// Averages pairs of source pixels vertically, W = sw and H = sh / 2.
+extern void fl_scale_down_2v(const uchar *src, int sw, int sh, int sld, int d,
+                             uchar *dst);
+
+#endif // fl_image_scale_h
@@ -90,8 +90,10 @@ fl_check_images(const char *name,               // I - Filename
 
   if (memcmp(header, "GIF87a", 6) == 0 ||
       memcmp(header, "GIF89a", 6) == 0) // GIF file
-    return Fl_GIF_Image::animate ? new Fl_Anim_GIF_Image(name) :
-                                   new Fl_GIF_Image(name);
+    // Fl_Anim_GIF_Image uses timeouts and shared images, which are
+    // reserved for the main thread
+    return Fl_GIF_Image::animate && !Fl_Shared_Image::loading_async() ?
+           new Fl_Anim_GIF_Image(name) : new Fl_GIF_Image(name);
 
   // BMP
 
@@ -118,8 +120,11 @@ fl_check_images(const char *name,               // I - Filename
 
 #ifdef HAVE_LIBJPEG
   if (memcmp(header, "\377\330\377", 3) == 0 && // Start-of-Image
-      header[3] >= 0xc0 && header[3] <= 0xfe)   // APPn .. comment for JPEG file
-    return new Fl_JPEG_Image(name);
+      header[3] >= 0xc0 && header[3] <= 0xfe) { // APPn .. comment for JPEG file
+    int W, H;                                   // decode thumbnails at a reduced size
+    Fl_Shared_Image::requested_size(W, H);
+    return new Fl_JPEG_Image(name, W, H);
+  }
 #endif // HAVE_LIBJPEG
 
   // SVG or SVGZ (gzip'ed SVG)
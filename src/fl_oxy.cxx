@@ -19,6 +19,7 @@
 #include <FL/fl_draw.H>
 #include <FL/Fl_Rect.H>
 #include "fl_oxy.h"
+#include "fl_box_cache.h"
 
 // Note:
 //
@@ -480,24 +481,52 @@ static void oxy_draw(int x, int y, int w, int h, Fl_Color col, int typebox, bool
 } // end `static void oxy_draw(...)'
 
 
-void fl_oxy_button_up_box(int x, int y, int w, int h, Fl_Color col) {
+// The box types with gradients are drawn through the box image cache
+
+static void oxy_button_up_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_BUTTON_UP_BOX, true);
 }
-void fl_oxy_button_down_box(int x, int y, int w, int h, Fl_Color col) {
+static void oxy_button_down_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_BUTTON_DOWN_BOX, true);
 }
-void fl_oxy_up_box(int x, int y, int w, int h, Fl_Color col) {
+static void oxy_up_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_UP_BOX, true);
 }
-void fl_oxy_down_box(int x, int y, int w, int h, Fl_Color col) {
+static void oxy_down_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_DOWN_BOX, true);
 }
-void fl_oxy_thin_up_box(int x, int y, int w, int h, Fl_Color col) {
+static void oxy_thin_up_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_UP_BOX, false);
 }
-void fl_oxy_thin_down_box(int x, int y, int w, int h, Fl_Color col) {
+static void oxy_thin_down_box(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_DOWN_BOX, false);
 }
+static void oxy_round_up_box(int x, int y, int w, int h, Fl_Color col) {
+  oxy_draw(x, y, w, h, col, FL_OXY_ROUND_UP_BOX, true);
+}
+static void oxy_round_down_box(int x, int y, int w, int h, Fl_Color col) {
+  oxy_draw(x, y, w, h, col, FL_OXY_ROUND_DOWN_BOX, true);
+}
+
+
+void fl_oxy_button_up_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_button_up_box, x, y, w, h, col);
+}
+void fl_oxy_button_down_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_button_down_box, x, y, w, h, col);
+}
+void fl_oxy_up_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_up_box, x, y, w, h, col);
+}
+void fl_oxy_down_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_down_box, x, y, w, h, col);
+}
+void fl_oxy_thin_up_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_thin_up_box, x, y, w, h, col);
+}
+void fl_oxy_thin_down_box(int x, int y, int w, int h, Fl_Color col) {
+  fl_cached_box(oxy_thin_down_box, x, y, w, h, col);
+}
 void fl_oxy_up_frame(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_UP_FRAME, true);
 }
@@ -511,9 +540,8 @@ void fl_oxy_thin_down_frame(int x, int y, int w, int h, Fl_Color col) {
   oxy_draw(x, y, w, h, col, FL_OXY_DOWN_FRAME, false);
 }
 void fl_oxy_round_up_box(int x, int y, int w, int h, Fl_Color col) {
-  oxy_draw(x, y, w, h, col, FL_OXY_ROUND_UP_BOX, true);
+  fl_cached_box(oxy_round_up_box, x, y, w, h, col);
 }
 void fl_oxy_round_down_box(int x, int y, int w, int h, Fl_Color col) {
-  oxy_draw(x, y, w, h, col, FL_OXY_ROUND_DOWN_BOX, true);
+  fl_cached_box(oxy_round_down_box, x, y, w, h, col);
 }
-
@@ -30,6 +30,7 @@
 #include <FL/Fl.H>
 #include <FL/Fl_Scheme.H>
 #include <FL/fl_draw.H>
+#include "fl_box_cache.h"
 
 #include <cassert>
 
@@ -92,6 +93,7 @@ static void set_color_average(int av) {
 */
 void Fl_Scheme::plastic_color_average(int av) {
   set_color_average(av);
+  fl_box_cache_clear();
 }
 
 // Get 'plastic' color average from environment variable 'FLTK_PLASTIC_AVERAGE'
@@ -333,7 +335,7 @@ static void narrow_thin_box(int x, int y, int w, int h, Fl_Color c) {
   }
 }
 
-void fl_plastic_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void thin_up_box(int x, int y, int w, int h, Fl_Color c) {
   if (w > 4 && h > 4) {
     shade_rect(x + 1, y + 1, w - 2, h - 3, "RQOQSUWQ", c);
     frame_rect(x, y, w, h - 1, "IJLM", c);
@@ -342,16 +344,16 @@ void fl_plastic_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
   }
 }
 
-void fl_plastic_up_box(int x, int y, int w, int h, Fl_Color c) {
+static void up_box(int x, int y, int w, int h, Fl_Color c) {
   if (w > 8 && h > 8) {
     shade_rect(x + 1, y + 1, w - 2, h - 3, "RVQNOPQRSTUVWVQ", c);
     frame_rect(x, y, w, h - 1, "IJLM", c);
   } else {
-    fl_plastic_thin_up_box(x, y, w, h, c);
+    thin_up_box(x, y, w, h, c);
   }
 }
 
-void fl_plastic_up_round(int x, int y, int w, int h, Fl_Color c) {
+static void up_round(int x, int y, int w, int h, Fl_Color c) {
   shade_round(x, y, w, h, "RVQNOPQRSTUVWVQ", c);
   frame_round(x, y, w, h, "IJLM", c);
 }
@@ -360,7 +362,7 @@ void fl_plastic_down_frame(int x, int y, int w, int h, Fl_Color c) {
   frame_rect(x, y, w, h - 1, "LLLLTTRR", c);
 }
 
-void fl_plastic_down_box(int x, int y, int w, int h, Fl_Color c) {
+static void down_box(int x, int y, int w, int h, Fl_Color c) {
   if (w > 6 && h > 6) {
     shade_rect(x + 2, y + 2, w - 4, h - 5, "STUVWWWVT", c);
     fl_plastic_down_frame(x, y, w, h, c);
@@ -370,7 +372,29 @@ void fl_plastic_down_box(int x, int y, int w, int h, Fl_Color c) {
   }
 }
 
-void fl_plastic_down_round(int x, int y, int w, int h, Fl_Color c) {
+static void down_round(int x, int y, int w, int h, Fl_Color c) {
   shade_round(x, y, w, h, "STUVWWWVT", c);
   frame_round(x, y, w, h, "IJLM", c);
 }
+
+// The shaded box types are drawn through the box image cache
+
+void fl_plastic_thin_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(thin_up_box, x, y, w, h, c);
+}
+
+void fl_plastic_up_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(up_box, x, y, w, h, c);
+}
+
+void fl_plastic_up_round(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(up_round, x, y, w, h, c);
+}
+
+void fl_plastic_down_box(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(down_box, x, y, w, h, c);
+}
+
+void fl_plastic_down_round(int x, int y, int w, int h, Fl_Color c) {
+  fl_cached_box(down_round, x, y, w, h, c);
+}
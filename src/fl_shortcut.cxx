@@ -81,6 +81,21 @@ int Fl::test_shortcut(unsigned int shortcut) {
   return 0;
 }
 
+// INTERNAL: Stores the values of (shortcut & FL_KEY_MASK) for which
+// Fl::test_shortcut(shortcut) can match the current event in keys[] and
+// returns their number. This is used by the shortcut indexes of Fl_Menu_
+// and Fl_Window to test only the shortcuts with one of these keys.
+int fl_shortcut_keys(unsigned int keys[3]) {
+  int n = 0;
+  keys[n++] = (unsigned)Fl::event_key();
+  unsigned int firstChar = fl_utf8decode(Fl::event_text(), Fl::event_text()+Fl::event_length(), 0);
+  if (firstChar != keys[0]) keys[n++] = firstChar;
+  // Ctrl+'_' kludge in Fl::test_shortcut()
+  unsigned int key = firstChar ^ 0x40;
+  if (Fl::event_state(FL_CTRL) && key >= 0x3f && key <= 0x5F) keys[n++] = key;
+  return n;
+}
+
 /**
   Get a human-readable string from a shortcut value.
 
@@ -0,0 +1,94 @@
+//
+// Fl_Grid layout benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// A grid of 60 x 40 cells like a large dashboard. The benchmark resizes
+// the grid as interactive resizing of the window does, and calls layout()
+// which calculates the minimal column and row sizes again, and shows how
+// many layouts per second are calculated. The window can also be resized
+// with the mouse to see how responsive the layout is.
+
+#include <FL/Fl.H>
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Grid.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_Button.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>
+
+static const int ROWS = 60;
+static const int COLS = 40;
+
+static Fl_Grid *grid;
+static Fl_Box *status;
+
+// runs fn for about half a second, returns the calls per second
+static double rate(void (*fn)(int)) {
+  int n = 0;
+  Fl_Timestamp start = Fl::now();
+  double t;
+  do {
+    fn(n++);
+  } while ((t = Fl::seconds_since(start)) < 0.5);
+  return n / t;
+}
+
+static void resize_grid(int n) {
+  grid->resize(grid->x(), grid->y(), grid->w() + (n & 1 ? 1 : -1), grid->h() + (n & 1 ? 1 : -1));
+}
+
+static void layout_grid(int) {
+  grid->layout();
+}
+
+static void run_cb(Fl_Widget *, void *) {
+  fl_cursor(FL_CURSOR_WAIT);
+  Fl::flush();
+  double resizes = rate(resize_grid);
+  double layouts = rate(layout_grid);
+  fl_cursor(FL_CURSOR_DEFAULT);
+  char buf[128];
+  snprintf(buf, sizeof(buf), "resize(): %.0f layouts/s   layout(): %.0f layouts/s",
+           resizes, layouts);
+  status->copy_label(buf);
+  printf("%d x %d cells: %s\n", ROWS, COLS, buf);
+}
+
+int main(int argc, char **argv) {
+  Fl_Double_Window *win = new Fl_Double_Window(820, 680, "Fl_Grid Benchmark");
+
+  grid = new Fl_Grid(0, 0, win->w(), win->h() - 40);
+  grid->layout(ROWS, COLS, 2, 1);
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      Fl_Box *b = new Fl_Box(0, 0, 16, 8);
+      b->box(FL_FLAT_BOX);
+      b->color((r + c) & 1 ? FL_LIGHT2 : FL_DARK1);
+      grid->widget(b, r, c);
+    }
+  }
+  grid->end();
+  grid->layout();
+
+  Fl_Button *run = new Fl_Button(10, win->h() - 35, 120, 30, "Run benchmark");
+  run->callback(run_cb);
+  status = new Fl_Box(140, win->h() - 35, win->w() - 150, 30);
+  status->align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
+  win->end();
+  win->resizable(grid);
+  win->size_range(300, 200);
+  win->show(argc, argv);
+  return Fl::run();
+}
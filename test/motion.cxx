@@ -0,0 +1,141 @@
+//
+// Mouse motion compression test program for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// Draw with the mouse or a tablet in the white area. Every motion event
+// takes the time set with the slider to handle, like a widget that does a
+// lot of work per event. With motion compression switched on, the motion
+// events that are queued while an event is handled are combined into one
+// event, and the skipped positions are drawn from Fl::event_history().
+// The status line shows how many positions were delivered by the system
+// and how many events were handled per second.
+
+#include <FL/Fl.H>
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_Check_Button.H>
+#include <FL/Fl_Value_Slider.H>
+#include <FL/fl_draw.H>
+#include <stdio.h>
+#include <vector>
+
+static Fl_Box *status;
+static Fl_Value_Slider *work;
+static int delivered = 0;   // positions reported by the system
+static int handled = 0;     // FL_MOVE and FL_DRAG events handled
+
+class Canvas : public Fl_Widget {
+  std::vector<int> points;  // x, y pairs, -1 starts a new stroke
+  void add(int X, int Y) {
+    points.push_back(X);
+    points.push_back(Y);
+  }
+public:
+  Canvas(int X, int Y, int W, int H) : Fl_Widget(X, Y, W, H) { }
+  void clear() {
+    points.clear();
+    redraw();
+  }
+  int handle(int event) override {
+    switch (event) {
+      case FL_PUSH:
+        add(-1, -1);
+        add(Fl::event_x(), Fl::event_y());
+        redraw();
+        return 1;
+      case FL_ENTER:
+        return 1;
+      case FL_MOVE:
+      case FL_DRAG: {
+        int n = Fl::event_history();
+        delivered += n + 1;
+        handled++;
+        if (event == FL_DRAG) {
+          for (int i = 0; i < n; i++)
+            add(Fl::event_history_x(i), Fl::event_history_y(i));
+          add(Fl::event_x(), Fl::event_y());
+          redraw();
+        }
+        // simulate a widget that takes some time for each event
+        Fl_Timestamp start = Fl::now();
+        while (Fl::seconds_since(start) * 1000.0 < work->value()) { }
+        return 1;
+      }
+      default:
+        return Fl_Widget::handle(event);
+    }
+  }
+  void draw() override {
+    fl_push_clip(x(), y(), w(), h());
+    fl_rectf(x(), y(), w(), h(), FL_WHITE);
+    fl_color(FL_BLACK);
+    bool open = false;
+    for (size_t i = 0; i < points.size(); i += 2) {
+      if (points[i] < 0) {
+        if (open) fl_end_line();
+        open = false;
+        continue;
+      }
+      if (!open) fl_begin_line();
+      open = true;
+      fl_vertex(points[i], points[i + 1]);
+    }
+    if (open) fl_end_line();
+    fl_pop_clip();
+  }
+};
+
+static Canvas *canvas;
+
+static void update_status(void *) {
+  char buf[128];
+  snprintf(buf, sizeof(buf), "delivered: %d positions/s   handled: %d events/s",
+           delivered, handled);
+  status->copy_label(buf);
+  delivered = handled = 0;
+  Fl::repeat_timeout(1.0, update_status);
+}
+
+static void compression_cb(Fl_Widget *w, void *) {
+  Fl::motion_compression(((Fl_Check_Button *)w)->value());
+}
+
+static void clear_cb(Fl_Widget *, void *) {
+  canvas->clear();
+}
+
+int main(int argc, char **argv) {
+  Fl_Double_Window *win = new Fl_Double_Window(520, 480, "Motion Compression");
+  canvas = new Canvas(10, 10, 500, 350);
+  Fl_Check_Button *compress = new Fl_Check_Button(10, 370, 200, 25, "Motion compression");
+  compress->callback(compression_cb);
+  Fl_Button *clear = new Fl_Button(410, 370, 100, 25, "Clear");
+  clear->callback(clear_cb);
+  work = new Fl_Value_Slider(10, 405, 500, 25, "Work per event (ms)");
+  work->type(FL_HOR_NICE_SLIDER);
+  work->align(FL_ALIGN_BOTTOM_LEFT);
+  work->bounds(0, 20);
+  work->step(0.5);
+  work->value(5);
+  status = new Fl_Box(10, 450, 500, 25);
+  status->box(FL_DOWN_BOX);
+  status->align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
+  win->end();
+  win->resizable(canvas);
+  win->show(argc, argv);
+  Fl::add_timeout(1.0, update_status);
+  return Fl::run();
+}
@@ -0,0 +1,92 @@
+//
+// Toolbar drawing benchmark for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2026 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// Toolbars with 320 buttons that show 24 x 24 pixel icons with alpha
+// channel, like the toolbars of a large application. The benchmark redraws
+// the window and shows how many times per second all icons are drawn. Each
+// redraw waits until the window system has finished drawing, by reading
+// back a pixel of the window.
+
+#include <FL/Fl.H>
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/fl_draw.H>
+#include <math.h>
+#include <stdio.h>
+
+static const int ROWS = 8;
+static const int COLS = 40;
+static const int ICON = 24;
+
+static Fl_Double_Window *win;
+static Fl_Box *status;
+
+// a round icon with soft edges and a color that depends on n
+static Fl_RGB_Image *make_icon(int n) {
+  uchar *p = new uchar[ICON * ICON * 4];
+  uchar *o = p;
+  for (int y = 0; y < ICON; y++) {
+    for (int x = 0; x < ICON; x++, o += 4) {
+      double r = hypot(x - ICON / 2 + 0.5, y - ICON / 2 + 0.5);
+      double a = (ICON / 2 - r) / 2;
+      o[0] = (uchar)(n * 37);
+      o[1] = (uchar)(255 - x * 8);
+      o[2] = (uchar)(y * 8 + n * 11);
+      o[3] = (uchar)(a <= 0 ? 0 : a >= 1 ? 255 : a * 255);
+    }
+  }
+  Fl_RGB_Image *img = new Fl_RGB_Image(p, ICON, ICON, 4);
+  img->alloc_array = 1;
+  return img;
+}
+
+static void run_cb(Fl_Widget *, void *) {
+  int n = 0;
+  Fl_Timestamp start = Fl::now();
+  double t;
+  do {
+    win->redraw();
+    Fl::flush();
+    win->make_current();
+    delete[] fl_read_image(0, 0, 0, 1, 1);
+    n++;
+  } while ((t = Fl::seconds_since(start)) < 1.0);
+  char buf[128];
+  snprintf(buf, sizeof(buf), "%.0f redraws/s, %.0f icons/s", n / t, n * ROWS * COLS / t);
+  status->copy_label(buf);
+  printf("%d icons: %s\n", ROWS * COLS, buf);
+}
+
+int main(int argc, char **argv) {
+  win = new Fl_Double_Window(COLS * 30 + 20, ROWS * 30 + 60, "Toolbar Benchmark");
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      Fl_Button *b = new Fl_Button(10 + c * 30, 10 + r * 30, 30, 30);
+      b->box(FL_FLAT_BOX);
+      b->down_box(FL_DOWN_BOX);
+      b->image(make_icon(r * COLS + c));
+    }
+  }
+  Fl_Button *run = new Fl_Button(10, win->h() - 40, 120, 30, "Run benchmark");
+  run->callback(run_cb);
+  status = new Fl_Box(140, win->h() - 40, win->w() - 150, 30);
+  status->align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
+  win->end();
+  win->show(argc, argv);
+  return Fl::run();
+}
@@ -18,13 +18,24 @@
 
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Button.H>
+#include <FL/Fl_Input.H>
+#include <FL/Fl_Multiline_Input.H>
+#include <FL/Fl_Box.H>
+#include <FL/Fl_Grid.H>
 #include <FL/Fl_Terminal.H>
 #include <FL/Fl_Preferences.H>
+#include <FL/Fl_Menu_Button.H>
+#include <FL/Fl_Text_Buffer.H>
+#include <FL/Fl_Value_Input.H>
+#include <FL/Fl_Window.H>
+#include <FL/headless.H>
+#include <FL/fl_draw.H>
 #include <FL/fl_callback_macros.H>
 #include <FL/filename.H>
 #include <FL/fl_utf8.h>
 
 #include <string>
+#include <string.h>
 
 
 /* Test additions to Fl_Preferences. */
@@ -50,6 +61,150 @@ TEST(Fl_Preferences, Strings) {
   return true;
 }
 
+/* Test groups and entries that are found through the hash tables. */
+TEST(Fl_Preferences, LargeGroups) {
+  char name[32];
+  {
+    Fl_Preferences prefs(Fl_Preferences::USER_L, "fltk.org", "unittests_large");
+    prefs.clear();
+    Fl_Preferences cols(prefs, "columns");
+    for (int i = 0; i < 1000; i++) {
+      snprintf(name, sizeof(name), "width%d", i);
+      cols.set(name, i);
+    }
+    for (int i = 0; i < 100; i++) {
+      snprintf(name, sizeof(name), "window%d/state", i);
+      Fl_Preferences win(prefs, name);
+      win.set("x", i);
+    }
+    cols.deleteEntry("width10");
+    prefs.deleteGroup("window20");
+    EXPECT_EQ(prefs.dirty(), 1);
+    EXPECT_EQ(prefs.flush(), 0);
+    EXPECT_EQ(prefs.dirty(), 0);  // the next flush() does not write the file
+  }
+  {
+    Fl_Preferences prefs(Fl_Preferences::USER_L, "fltk.org", "unittests_large");
+    Fl_Preferences cols(prefs, "columns");
+    EXPECT_EQ(cols.entries(), 999);
+    EXPECT_EQ(cols.entryExists("width10"), 0);
+    int v = -1;
+    cols.get("width999", v, -1);
+    EXPECT_EQ(v, 999);
+    cols.get("width11", v, -1);
+    EXPECT_EQ(v, 11);
+    EXPECT_EQ(prefs.groups(), 100);
+    EXPECT_EQ(prefs.groupExists("window20"), 0);
+    Fl_Preferences win(prefs, "window42/state");
+    win.get("x", v, -1);
+    EXPECT_EQ(v, 42);
+    EXPECT_STREQ(prefs.group(0), "columns");
+  }
+  {
+    Fl_Preferences prefs(Fl_Preferences::USER_L, "fltk.org", "unittests_large");
+    prefs.clear();
+  }
+  return true;
+}
+
+// a directory for preferences files that are removed by the test
+static const char *ut_temp_dir() {
+  const char *dir = fl_getenv("TMPDIR");
+  if (!dir || !*dir) dir = fl_getenv("TEMP");
+  if (!dir || !*dir) dir = "/tmp";
+  return dir;
+}
+
+/* Test binary values that are stored in the separate binary file. */
+TEST(Fl_Preferences, BinaryFile) {
+  unsigned char large[1000], small[10];
+  for (int i = 0; i < 1000; i++) large[i] = (unsigned char)(i * 7);
+  for (int i = 0; i < 10; i++) small[i] = (unsigned char)i;
+  Fl_Preferences::binary_threshold(64);
+  char filename[FL_PATH_MAX];
+  std::string blobs;
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.clear();
+    prefs.set("large", large, 1000);
+    prefs.set("small", small, 10);
+    prefs.set("replaced", small, 10);
+    prefs.set("replaced", large, 500);
+    prefs.filename(filename, sizeof(filename));
+    blobs = std::string(filename, strlen(filename) - 6) + ".blobs";
+  }
+  EXPECT_EQ(fl_access(blobs.c_str(), 0), 0);
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    const void *data = NULL;
+    int size = 0;
+    EXPECT_EQ(prefs.get_binary("large", data, size), 1);
+    EXPECT_EQ(size, 1000);
+    EXPECT_TRUE(data && memcmp(data, large, 1000) == 0);
+    EXPECT_EQ(prefs.get_binary("small", data, size), 0); // stored as text
+    EXPECT_EQ(prefs.size("large"), 2000);
+    unsigned char buffer[1000];
+    size = 1000;
+    EXPECT_EQ(prefs.get("replaced", buffer, NULL, 0, &size), 1);
+    EXPECT_EQ(size, 500);
+    EXPECT_TRUE(memcmp(buffer, large, 500) == 0);
+    EXPECT_EQ(prefs.get("small", buffer, NULL, 0, 10), 1);
+    EXPECT_TRUE(memcmp(buffer, small, 10) == 0);
+    prefs.set("large", large, 1000); // unchanged
+    EXPECT_EQ(prefs.dirty(), 0);
+    prefs.clear();
+  }
+  // the binary file is removed when no value refers to it
+  EXPECT_TRUE(fl_access(blobs.c_str(), 0) != 0);
+  // and so it is when the values are removed without reading them
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.set("large", large, 1000);
+  }
+  EXPECT_EQ(fl_access(blobs.c_str(), 0), 0);
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.deleteEntry("large");
+  }
+  EXPECT_TRUE(fl_access(blobs.c_str(), 0) != 0);
+  // the old values stay in the binary file until new preferences are written
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.set("large", large, 1000);
+  }
+  std::string tmpname = std::string(filename) + ".tmp";
+  fl_mkdir(tmpname.c_str(), 0700);      // writing the preferences fails
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.set("large", large + 1, 999);
+    prefs.flush();
+    Fl_Preferences old(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    const void *data = NULL;
+    int size = 0;
+    EXPECT_EQ(old.get_binary("large", data, size), 1);
+    EXPECT_EQ(size, 1000);
+    EXPECT_TRUE(data && memcmp(data, large, 1000) == 0);
+  }
+  fl_rmdir(tmpname.c_str());
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.clear();
+  }
+  EXPECT_TRUE(fl_access(blobs.c_str(), 0) != 0);
+  // a binary file that the preferences never referred to is not removed
+  FILE *f = fl_fopen(blobs.c_str(), "wb");
+  if (f) fclose(f);
+  {
+    Fl_Preferences prefs(ut_temp_dir(), "fltk.org", "unittests_binary", Fl_Preferences::C_LOCALE);
+    prefs.set("text", "no binary values");
+  }
+  EXPECT_EQ(fl_access(blobs.c_str(), 0), 0);
+  fl_unlink(blobs.c_str());
+  Fl_Preferences::binary_threshold(0);
+  fl_unlink(filename);
+  return true;
+}
+
 #if 0
 
 TEST(fl_filename, ext) {
@@ -167,6 +322,517 @@ TEST(Fl_Callback_Macros, FL_INLINE_CALLBACK) {
 
 #endif // FIXME - Fl_String
 
+static void menu_cb(Fl_Widget *, void *) { }
+
+/* Test that Fl_Menu_::add_batch() creates the same menu as add(). */
+TEST(Fl_Menu_, add_batch) {
+  Fl_Group::current(NULL);
+  static const Fl_Menu_Item items[] = {
+    { "&File/&Open", FL_COMMAND+'o', menu_cb, (void*)1 },
+    { "File/Save", 0, menu_cb, (void*)2, FL_MENU_DIVIDER },
+    { "_File/&Recent/a\\/b.txt", 0, menu_cb, (void*)3 },
+    { "Edit/Copy", 0, menu_cb, (void*)4 },
+    { "File/Recent/c.txt", 0, menu_cb, (void*)5, FL_MENU_TOGGLE },
+    { "File/&Open", FL_COMMAND+'p', menu_cb, (void*)6 },
+    { "/usr/local/bin", 0, menu_cb, (void*)7 },
+    { "Edit/Sub", 0, 0, 0, FL_SUBMENU },
+    { "Edit/Sub/Deep", 0, menu_cb, (void*)8 },
+    { 0 }
+  };
+  Fl_Menu_Button a(0, 0, 10, 10), b(0, 0, 10, 10);
+  a.add("Help/About");
+  b.add("Help/About");
+  for (int i = 0; items[i].text; i++)
+    a.add(items[i].text, items[i].shortcut_, items[i].callback_, items[i].user_data_, items[i].flags);
+  EXPECT_EQ(b.add_batch(items), a.find_index("Edit/Sub/Deep"));
+  EXPECT_EQ(a.size(), b.size());
+  for (int i = 0; i < a.size() && i < b.size(); i++) {
+    const Fl_Menu_Item &ma = a.menu()[i], &mb = b.menu()[i];
+    EXPECT_STREQ(ma.text ? ma.text : "(null)", mb.text ? mb.text : "(null)");
+    EXPECT_EQ(ma.flags, mb.flags);
+    EXPECT_EQ(ma.shortcut_, mb.shortcut_);
+    EXPECT_TRUE(ma.user_data_ == mb.user_data_);
+  }
+  // the pathname index must find the same items as the linear search
+  b.path_index(1);
+  const char *paths[] = { "&File/&Open", "File/Save", "&File/&Recent/a/b.txt", "Edit",
+                          "Edit/Sub/Deep", "/usr/local/bin", "Help/About", "File/Quit" };
+  for (unsigned i = 0; i < sizeof(paths)/sizeof(paths[0]); i++) {
+    EXPECT_EQ(b.find_index(paths[i]), a.find_index(paths[i]));
+  }
+  b.remove(b.find_index("File/Save"));
+  a.remove(a.find_index("File/Save"));
+  EXPECT_EQ(b.find_index("Edit/Copy"), a.find_index("Edit/Copy"));
+  EXPECT_EQ(b.find_index("File/Save"), -1);
+  return true;
+}
+
+TEST(Fl_Menu_, shortcut_index) {
+  Fl_Group::current(NULL);
+  Fl_Menu_Button a(0, 0, 10, 10), b(0, 0, 10, 10);
+  b.shortcut_index(1);
+  Fl_Menu_Button *m[2] = { &a, &b };
+  for (int i = 0; i < 2; i++) {
+    m[i]->add("File/Open", FL_CTRL+'o', menu_cb);
+    m[i]->add("File/Sub/Save", FL_CTRL+'s', menu_cb);
+    m[i]->add("File/Sub/Quit", FL_CTRL+'Q', menu_cb);
+    m[i]->add("Edit/Save", FL_CTRL+'s', menu_cb);
+    m[i]->add("Edit/Undo", FL_CTRL+'z', menu_cb, 0, FL_MENU_INACTIVE);
+    m[i]->add("Edit/Redo", FL_CTRL+'z', menu_cb);
+    m[i]->add("Top", FL_CTRL+'s', menu_cb);
+    m[i]->add("Tools/Run", FL_F+5, menu_cb);
+    m[i]->add("Tools/Under", FL_CTRL+'_', menu_cb);
+  }
+  struct { int key, state; const char *text; } keys[] = {
+    { 'o', FL_CTRL, "\017" }, { 's', FL_CTRL, "\023" }, { 'q', FL_CTRL|FL_SHIFT, "\021" },
+    { 'z', FL_CTRL, "\032" }, { FL_F+5, 0, "" }, { '-', FL_CTRL|FL_SHIFT, "\037" },
+    { 'x', FL_CTRL, "\030" }, { 'o', 0, "o" }
+  };
+  for (int pass = 0; pass < 2; pass++) {
+    for (unsigned i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+      Fl::e_keysym = keys[i].key;
+      Fl::e_state = keys[i].state;
+      Fl::e_text = (char*)keys[i].text;
+      Fl::e_length = (int)strlen(keys[i].text);
+      const Fl_Menu_Item *ma = a.test_shortcut(), *mb = b.test_shortcut();
+      EXPECT_EQ(ma ? a.find_index(ma) : -1, mb ? b.find_index(mb) : -1);
+    }
+    // the index must follow changes of the menu
+    a.remove(a.find_index("Top"));
+    b.remove(b.find_index("Top"));
+    a.mode(a.find_index("File"), FL_SUBMENU|FL_MENU_INACTIVE);
+    b.mode(b.find_index("File"), FL_SUBMENU|FL_MENU_INACTIVE);
+  }
+  Fl::e_keysym = Fl::e_state = Fl::e_length = 0;
+  Fl::e_text = (char*)"";
+  return true;
+}
+
+TEST(Fl_Menu_, shortcut_index_invisible) {
+  Fl_Group::current(NULL);
+  Fl_Menu_Button a(0, 0, 10, 10), b(0, 0, 10, 10);
+  b.shortcut_index(1);
+  Fl_Menu_Button *m[2] = { &a, &b };
+  for (int i = 0; i < 2; i++) {
+    m[i]->add("Edit/Hidden", FL_CTRL+'h', menu_cb, 0, FL_MENU_INVISIBLE);
+    m[i]->add("View/Zoom", FL_CTRL+'y', menu_cb);
+    int view = m[i]->find_index("View");
+    m[i]->mode(view, m[i]->mode(view) | FL_MENU_INVISIBLE);
+  }
+  // invisible items and the items of invisible submenus keep their shortcuts
+  Fl::e_state = FL_CTRL;
+  Fl::e_keysym = 'h';
+  Fl::e_text = (char*)"\010";
+  Fl::e_length = 1;
+  EXPECT_EQ(a.find_index(a.test_shortcut()), a.find_index("Edit/Hidden"));
+  EXPECT_EQ(b.find_index(b.test_shortcut()), b.find_index("Edit/Hidden"));
+  Fl::e_keysym = 'y';
+  Fl::e_text = (char*)"\031";
+  EXPECT_EQ(a.find_index(a.test_shortcut()), a.find_index("View/Zoom"));
+  EXPECT_EQ(b.find_index(b.test_shortcut()), b.find_index("View/Zoom"));
+  Fl::e_keysym = Fl::e_state = Fl::e_length = 0;
+  Fl::e_text = (char*)"";
+  return true;
+}
+
+/* Test that watched widget pointers are cleared when the widget is deleted. */
+TEST(Fl_Widget_Tracker, delete_widget) {
+  Fl_Group::current(NULL);
+  Fl_Button *a = new Fl_Button(0, 0, 10, 10), *b = new Fl_Button(0, 0, 10, 10);
+  Fl_Widget *p1 = a, *p2 = a, *p3 = b;
+  Fl::watch_widget_pointer(p1);
+  Fl::watch_widget_pointer(p2);
+  Fl::watch_widget_pointer(p2); // watching twice is the same as once
+  Fl::watch_widget_pointer(p3);
+  {
+    Fl_Widget_Tracker t(a), u(b);
+    Fl::release_widget_pointer(p2);
+    delete a;
+    EXPECT_TRUE(t.deleted());
+    EXPECT_TRUE(u.exists());
+    EXPECT_TRUE(p1 == NULL);
+    EXPECT_TRUE(p2 == a); // released before the widget was deleted
+    EXPECT_TRUE(p3 == b);
+  }
+  // a pointer that was cleared can watch another widget
+  p1 = b;
+  Fl::watch_widget_pointer(p1);
+  delete b;
+  EXPECT_TRUE(p1 == NULL);
+  EXPECT_TRUE(p3 == NULL);
+  Fl::release_widget_pointer(p1);
+  Fl::release_widget_pointer(p3);
+  Fl::release_widget_pointer(p3); // releasing twice does nothing
+  return true;
+}
+
+TEST(Fl_Widget_Tracker, watch_then_assign) {
+  Fl_Group::current(NULL);
+  Fl_Button *a = new Fl_Button(0, 0, 10, 10), *b = new Fl_Button(0, 0, 10, 10);
+  Fl_Widget *p = NULL, *q = a;
+  Fl::watch_widget_pointer(p);
+  Fl::watch_widget_pointer(q);
+  p = a;                        // assigned after it was watched
+  q = b;                        // changed to another widget
+  delete a;
+  EXPECT_TRUE(p == NULL);
+  EXPECT_TRUE(q == b);
+  delete b;
+  EXPECT_TRUE(q == NULL);       // still watched after its first widget was deleted
+  Fl::release_widget_pointer(p);
+  Fl::release_widget_pointer(q);
+  return true;
+}
+
+// a widget that remembers which instance received the last FL_PUSH event
+class Ut_Push_Box : public Fl_Widget {
+public:
+  static Ut_Push_Box *pushed;
+  Ut_Push_Box(int X, int Y, int W, int H) : Fl_Widget(X, Y, W, H) { }
+  void draw() FL_OVERRIDE { }
+  int handle(int e) FL_OVERRIDE {
+    if (e != FL_PUSH) return 0;
+    pushed = this;
+    return 1;
+  }
+};
+Ut_Push_Box *Ut_Push_Box::pushed = NULL;
+
+// the topmost child at X, Y that takes events, like Fl_Group::handle()
+static Fl_Widget *child_at(Fl_Group &g, int X, int Y) {
+  for (int i = g.children(); i--;) {
+    Fl_Widget *o = g.child(i);
+    if (o->takesevents() && X >= o->x() && X < o->x() + o->w() && Y >= o->y() && Y < o->y() + o->h())
+      return o;
+  }
+  return NULL;
+}
+
+// checks that FL_PUSH events are sent to the same children as without index
+static int push_mismatches(Fl_Group &g) {
+  int bad = 0;
+  for (int Y = -5; Y < 410; Y += 7) {
+    for (int X = -5; X < 410; X += 5) {
+      Ut_Push_Box::pushed = NULL;
+      Fl::e_x = X;
+      Fl::e_y = Y;
+      g.handle(FL_PUSH);
+      if (Ut_Push_Box::pushed != child_at(g, X, Y)) bad++;
+    }
+  }
+  Fl::pushed(NULL);
+  return bad;
+}
+
+/* Test that events go to the same children with and without spatial index. */
+TEST(Fl_Group, spatial_index) {
+  Fl_Group::current(NULL);
+  Fl_Group g(0, 0, 400, 400);
+  for (int i = 0; i < 2000; i++) {
+    int X = (i * 37) % 390, Y = (i * 53 + i / 7) % 390;
+    new Ut_Push_Box(X, Y, 5 + i % 13, 4 + i % 11);
+  }
+  new Ut_Push_Box(100, 100, 250, 250); // covers many cells
+  g.end();
+  g.child(7)->hide();
+  EXPECT_EQ(push_mismatches(g), 0);
+  g.spatial_index(1);
+  EXPECT_EQ(g.spatial_index(), 1);
+  EXPECT_EQ(push_mismatches(g), 0);
+  // the index follows changes of the children
+  g.child(10)->resize(200, 200, 30, 30);
+  g.insert(*g.child(g.children() - 1), 5);
+  g.insert(*new Ut_Push_Box(50, 60, 20, 20), 3);
+  g.delete_child(100);
+  g.add(new Ut_Push_Box(300, 10, 40, 40));
+  EXPECT_EQ(push_mismatches(g), 0);
+  g.resize(10, 20, 400, 400); // moves all children
+  g.resize(0, 0, 400, 400);
+  g.child(20)->position(0, 0);
+  EXPECT_EQ(push_mismatches(g), 0);
+  g.spatial_index(0);
+  EXPECT_EQ(g.spatial_index(), 0);
+  return true;
+}
+
+// the internal input of Fl_Value_Input has a parent that is not a group
+TEST(Fl_Group, spatial_index_value_input) {
+  Fl_Group::current(NULL);
+  Fl_Group g(0, 0, 200, 100);
+  g.spatial_index(1);
+  Fl_Value_Input *v = new Fl_Value_Input(10, 10, 80, 25);
+  g.end();
+  v->resize(20, 20, 100, 30);
+  g.resize(0, 0, 300, 200);
+  EXPECT_EQ(v->w(), 150);
+  Fl_Value_Input free_v(0, 0, 50, 20);
+  free_v.resize(5, 5, 60, 25);
+  EXPECT_EQ(free_v.x(), 5);
+  return true;
+}
+
+/* Test that a resize uses the new minimal sizes of changed cells. */
+TEST(Fl_Grid, cell_changes) {
+  Fl_Group::current(NULL);
+  Fl_Grid grid(0, 0, 200, 100);
+  grid.layout(1, 3);
+  Fl_Box *a = new Fl_Box(0, 0, 10, 10);
+  Fl_Box *b = new Fl_Box(0, 0, 10, 10);
+  grid.end();
+  Fl_Grid::Cell *ca = grid.widget(a, 0, 0);
+  grid.widget(b, 0, 2);
+  grid.col_weight(0, 0);                  // column 2 gets all extra space
+  grid.col_weight(1, 0);
+  grid.layout();
+  EXPECT_EQ(a->w(), 10);
+  EXPECT_EQ(b->x(), 10);
+  ca->minimum_size(60, 20);
+  grid.resize(0, 0, 300, 100);
+  EXPECT_EQ(a->w(), 60);
+  EXPECT_EQ(b->x(), 60);
+  ca->colspan(2);                         // spanning cells don't set column widths
+  grid.resize(0, 0, 200, 100);
+  EXPECT_EQ(a->w(), 0);
+  EXPECT_EQ(b->x(), 0);
+  return true;
+}
+
+/* Test that replace() keeps the text within maximum_size() characters. */
+TEST(Fl_Input_, maximum_size) {
+  Fl_Group::current(NULL);
+  Fl_Input in(0, 0, 100, 20);
+  in.maximum_size(5);
+  in.replace(0, 0, "abcdefgh");
+  EXPECT_STREQ(in.value(), "abcde");
+  in.replace(5, 5, "x");                  // the text is full
+  EXPECT_STREQ(in.value(), "abcde");
+  in.replace(1, 3, "\xc3\xbc");           // as many bytes as removed
+  EXPECT_STREQ(in.value(), "a\xc3\xbc" "de");
+  in.replace(in.size(), in.size(), "\xc3\xb6\xc3\xb6"); // characters count, not bytes
+  EXPECT_STREQ(in.value(), "a\xc3\xbc" "de\xc3\xb6");
+  EXPECT_EQ(in.size(), 7);
+  return true;
+}
+
+// measures 6 pixels per byte, so that text can be wrapped without a display
+class Ut_Fixed_Width_Driver : public Fl_Graphics_Driver {
+public:
+  double width(const char *, int n) FL_OVERRIDE { return 6.0 * n; }
+};
+
+class Ut_Wrap_Input : public Fl_Multiline_Input {
+public:
+  Ut_Wrap_Input(int X, int Y, int W, int H) : Fl_Multiline_Input(X, Y, W, H) {
+    wrap(1);
+  }
+  // a click builds the table of displayed lines
+  void click() { Fl_Input_::handle_mouse(x(), y(), w(), h(), 0); }
+  using Fl_Multiline_Input::line_start;
+  using Fl_Multiline_Input::line_end;
+};
+
+// counts the indexes where the line table of a differs from measuring the lines of b
+static int line_mismatches(Ut_Wrap_Input &a, Ut_Wrap_Input &b) {
+  b.value(a.value());
+  int bad = 0;
+  for (int i = 0; i <= a.size(); i++) {
+    if (a.line_start(i) != b.line_start(i) || a.line_end(i) != b.line_end(i)) bad++;
+  }
+  return bad;
+}
+
+/* Test that editing updates the displayed lines like a full rebuild. */
+TEST(Fl_Input_, line_table) {
+  Fl_Group::current(NULL);
+  Fl_Graphics_Driver *saved = fl_graphics_driver;
+  Ut_Fixed_Width_Driver driver;
+  fl_graphics_driver = &driver;
+  Ut_Wrap_Input a(0, 0, 200, 100), b(0, 0, 200, 100);
+  a.value("The quick brown fox jumps over the lazy dog, then it runs around the "
+          "field until it is tired.\n\nShort line\nAnother paragraph that "
+          "is long enough to be wrapped over several lines of the widget.");
+  a.click();
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.replace(10, 10, "and very very slow ");             // insert in a wrapped line
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.replace(30, 120, "x");                              // delete across lines
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.replace(a.size(), a.size(), " tail\nwords words words words words words");
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.replace(0, 4, "A");                                 // pulls words up
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.undo();
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.undo();
+  a.undo();
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.redo();
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  a.box(FL_BORDER_BOX);                                 // wraps wider
+  b.box(FL_BORDER_BOX);
+  a.click();
+  EXPECT_EQ(line_mismatches(a, b), 0);
+  fl_graphics_driver = saved;
+  return true;
+}
+
+#if FLTK_USE_HEADLESS
+
+static int ut_pushed = 0;
+static void ut_push_cb(Fl_Widget*, void*) { ut_pushed++; }
+
+static void ut_type(Fl_Window *win, int key) {
+  fl_headless_key_event(win, FL_KEYDOWN, key);
+  fl_headless_key_event(win, FL_KEYUP, key);
+}
+
+/* Test drawing and event injection of the headless backend.
+   Run with FLTK_BACKEND=headless, the test has nothing to check otherwise. */
+TEST(headless, window) {
+  if (!fl_headless_backend())
+    return true;
+  Fl_Group::current(NULL);
+  Fl_Window win(200, 100);
+  Fl_Input in(10, 10, 180, 25);
+  Fl_Button btn(10, 50, 80, 25, "OK");
+  Fl_Box red(150, 50, 40, 40);
+  red.box(FL_FLAT_BOX);
+  red.color(FL_RED);
+  win.end();
+  btn.callback(ut_push_cb);
+  win.show();
+  Fl::flush();
+  // the window was drawn into its buffer
+  Fl_RGB_Image *img = fl_capture_window(&win, 160, 60, 2, 2);
+  EXPECT_TRUE(img != NULL);
+  uchar rgb[3];
+  memcpy(rgb, img->data()[0], 3);
+  delete img;
+  EXPECT_EQ(rgb[0], 255);
+  EXPECT_EQ(rgb[1], 0);
+  EXPECT_EQ(rgb[2], 0);
+  // click into the input and type some text
+  fl_headless_mouse_event(&win, FL_PUSH, 20, 20);
+  fl_headless_mouse_event(&win, FL_RELEASE, 20, 20);
+  EXPECT_TRUE(Fl::focus() == &in);
+  ut_type(&win, 'h');
+  ut_type(&win, 'i');
+  fl_headless_key_event(&win, FL_KEYDOWN, FL_Shift_L);
+  ut_type(&win, 'a');
+  fl_headless_key_event(&win, FL_KEYUP, FL_Shift_L);
+  ut_type(&win, 'b');
+  EXPECT_STREQ(in.value(), "hiAb");
+  ut_type(&win, FL_BackSpace);
+  EXPECT_STREQ(in.value(), "hiA");
+  // click the button
+  ut_pushed = 0;
+  fl_headless_mouse_event(&win, FL_PUSH, 30, 60);
+  fl_headless_mouse_event(&win, FL_RELEASE, 30, 60);
+  EXPECT_EQ(ut_pushed, 1);
+  // releasing the mouse outside of the button does not trigger it
+  fl_headless_mouse_event(&win, FL_PUSH, 30, 60);
+  fl_headless_mouse_event(&win, FL_MOVE, 120, 60);
+  fl_headless_mouse_event(&win, FL_RELEASE, 120, 60);
+  EXPECT_EQ(ut_pushed, 1);
+  win.hide();
+  return true;
+}
+
+#endif // FLTK_USE_HEADLESS
+
+// returns the text of a buffer, valid until the next call
+static const char *ut_text(Fl_Text_Buffer &buf) {
+  static std::string s;
+  char *t = buf.text();
+  s = t;
+  free(t);
+  return s.c_str();
+}
+
+TEST(Fl_Text_Buffer, undo) {
+  Fl_Text_Buffer buf;
+  // a run of deletions with the delete key is undone in one step
+  buf.text("hello world");
+  for (int i = 0; i < 5; i++)
+    buf.remove(0, 1);
+  EXPECT_STREQ(ut_text(buf), " world");
+  EXPECT_EQ(buf.undo(), 1);
+  EXPECT_STREQ(ut_text(buf), "hello world");
+  EXPECT_EQ(buf.redo(), 1);
+  EXPECT_STREQ(ut_text(buf), " world");
+  // and so is a run of deletions with backspace
+  buf.text("abcdef");
+  for (int i = 6; i > 3; i--)
+    buf.remove(i - 1, i);
+  EXPECT_STREQ(ut_text(buf), "abc");
+  EXPECT_EQ(buf.undo(), 1);
+  EXPECT_STREQ(ut_text(buf), "abcdef");
+  // the oldest actions are dropped when the memory limit is exceeded
+  buf.text(std::string(200000, 'x').c_str());
+  for (int i = 0; i < 100; i++)
+    buf.remove(i & 1 ? 0 : buf.length() - 1000, i & 1 ? 1000 : buf.length());
+  EXPECT_TRUE(buf.undo_memory() > 100000);
+  buf.undo_memory_limit(20000);
+  EXPECT_TRUE(buf.undo_memory() <= 20000);
+  int n = 0;
+  while (buf.undo())
+    n++;
+  EXPECT_TRUE(n > 10 && n < 100);
+  EXPECT_TRUE(buf.length() < 200000);
+  return true;
+}
+
+// records the callbacks of a text buffer
+static int ut_predeletes, ut_modifies;
+static std::string ut_predeleted, ut_deleted, ut_inserted;
+
+static void ut_predelete_cb(int pos, int nDeleted, void *v) {
+  Fl_Text_Buffer *buf = (Fl_Text_Buffer *)v;
+  char *t = buf->text_range(pos, pos + nDeleted);
+  ut_predeleted = t;
+  free(t);
+  ut_predeletes++;
+}
+
+static void ut_modify_cb(int pos, int nInserted, int nDeleted, int, const char *deletedText, void *v) {
+  Fl_Text_Buffer *buf = (Fl_Text_Buffer *)v;
+  char *t = buf->text_range(pos, pos + nInserted);
+  ut_inserted = t;
+  free(t);
+  ut_deleted = nDeleted ? std::string(deletedText, nDeleted) : std::string();
+  ut_modifies++;
+}
+
+TEST(Fl_Text_Buffer, batch) {
+  Fl_Text_Buffer buf;
+  buf.text("one two three four five");
+  buf.add_predelete_callback(ut_predelete_cb, &buf);
+  buf.add_modify_callback(ut_modify_cb, &buf);
+  ut_predeletes = ut_modifies = 0;
+  buf.begin_batch();
+  buf.replace(4, 7, "2");           // one 2 three four five
+  buf.begin_batch();                // nested batches end with the outermost one
+  buf.insert(0, "[");               // [one 2 three four five
+  buf.end_batch();
+  buf.remove(13, 18);               // [one 2 three five
+  EXPECT_EQ(ut_modifies, 0);
+  buf.end_batch();
+  EXPECT_STREQ(ut_text(buf), "[one 2 three five");
+  // one notification for the range that contains all changes
+  EXPECT_EQ(ut_predeletes, 1);
+  EXPECT_EQ(ut_modifies, 1);
+  EXPECT_STREQ(ut_predeleted.c_str(), "one two three four ");
+  EXPECT_STREQ(ut_deleted.c_str(), "one two three four ");
+  EXPECT_STREQ(ut_inserted.c_str(), "[one 2 three ");
+  // each change can still be undone
+  EXPECT_EQ(buf.undo(), 1);
+  EXPECT_STREQ(ut_text(buf), "[one 2 three four five");
+  EXPECT_EQ(ut_modifies, 2);
+  buf.remove_modify_callback(ut_modify_cb, &buf);
+  buf.remove_predelete_callback(ut_predelete_cb, &buf);
+  return true;
+}
+
 //
 //------- test aspects of the FLTK core library ----------
 //